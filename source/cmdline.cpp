@@ -21,17 +21,20 @@ static SIntTxt TypeOptionNames[] = {
     {CMDL_OUTPUT_PE,    "cof"},
     {CMDL_OUTPUT_PE,    "win"},
     {CMDL_OUTPUT_OMF,   "omf"},
-    {CMDL_OUTPUT_MACHO, "mac"},
-    {CMDL_OUTPUT_MACHO, "macho"},
+    {CMDL_OUTPUT_MACHO, "macho"},     // Longer names before "mac" so that word size is found
     {CMDL_OUTPUT_MACHO, "mach-o"},
     {CMDL_OUTPUT_MACHO, "mach"},
+    {CMDL_OUTPUT_MACHO, "mac"},
     {CMDL_OUTPUT_MASM,  "asm"},
     {CMDL_OUTPUT_MASM,  "masm"},
     {CMDL_OUTPUT_MASM,  "tasm"},
     {CMDL_OUTPUT_MASM,  "nasm"},
     {CMDL_OUTPUT_MASM,  "yasm"},
     {CMDL_OUTPUT_MASM,  "gasm"},
-    {CMDL_OUTPUT_MASM,  "gas"}
+    {CMDL_OUTPUT_MASM,  "gas"},
+    {CMDL_OUTPUT_MASM,  "json"},
+    {CMDL_OUTPUT_MASM,  "bin"},
+    {CMDL_OUTPUT_MASM,  "stat"}
 };
 
 // List of subtype names
@@ -42,7 +45,10 @@ static SIntTxt SubtypeNames[] = {
     {SUBTYPE_NASM,  "nasm"},
     {SUBTYPE_NASM,  "yasm"},
     {SUBTYPE_GASM,  "gasm"},
-    {SUBTYPE_GASM,  "gas"}
+    {SUBTYPE_GASM,  "gas"},
+    {SUBTYPE_JSON,  "json"},
+    {SUBTYPE_BINREC,"bin"},
+    {SUBTYPE_STAT,  "stat"}
 };
 
 // List of standard names that are always translated
@@ -101,8 +107,9 @@ void CCommandLineInterpreter::ReadCommandLine(int argc, char * argv[]) {
         // Adding object files to library. Library may not exist
         FileOptions = CMDL_FILE_IN_IF_EXISTS;
     }
-    if (DumpOptions || ((LibraryOptions & CMDL_LIBRARY_EXTRACTMEM) && !(LibraryOptions & CMDL_LIBRARY_ADDMEMBER))) {
-        // Dumping or extracting. Output file not used
+    if (DumpOptions || (LibraryOptions & CMDL_LIBRARY_FINDSYMBOL)
+    || ((LibraryOptions & CMDL_LIBRARY_EXTRACTMEM) && !(LibraryOptions & CMDL_LIBRARY_ADDMEMBER))) {
+        // Dumping, searching or extracting. Output file not used
         if (OutputFile) err.submit(1103); // Output file name ignored
         OutputFile = 0;
     }
@@ -269,6 +276,10 @@ void CCommandLineInterpreter::InterpretCommandOption(char * string) {
         InterpretVerboseOption(string+1);  break;
 
     case 'd': case 'D':   // dump option
+        if (strnicmp(string+1, "func:", 5) == 0) {
+            // -dfunc: selective disassembly
+            InterpretDisasmSelectOption(string+6);  break;
+        }
         InterpretDumpOption(string+1);  break;
         // Debug info option
         //InterpretDebugInfoOption(string+1);  break;
@@ -276,6 +287,18 @@ void CCommandLineInterpreter::InterpretCommandOption(char * string) {
     case 'x': case 'X':   // Exception handler info option
         InterpretExceptionInfoOption(string+1);  break;
 
+    case 'g': case 'G':   // Section garbage collection option
+        if ((string[1] | 0x20) == 'c' && string[2] == 0) {
+            SectionGC = 1;  break;
+        }
+        err.submit(1002, string);  break;
+
+    case 's': case 'S':   // String table option
+        if ((string[1] | 0x20) == 'm' && string[2] == 0) {
+            SuffixMerge = 1;  break;
+        }
+        err.submit(1002, string);  break;
+
     case 'h': case 'H': case '?':  // Help
         ShowHelp = 1;  break;
 
@@ -332,6 +355,12 @@ void CCommandLineInterpreter::InterpretLibraryOption(char * string) {
         // name1 found
         separator = string[2];
         name1 = string+3;
+        if ((string[1] | 0x20) == 'f') {
+            // -lf takes a list of symbol names. The separator works as a comma here
+            for (i = 3; string[i]; i++) {
+                if (string[i] == separator) string[i] = ',';
+            }
+        }
         // Search for second separator or end
         name2 = name1 + 1;
         while (name2[0] != 0) {
@@ -402,6 +431,32 @@ void CCommandLineInterpreter::InterpretLibraryOption(char * string) {
         cmd.LibrarySubtype = LIBTYPE_SHORTNAMES;
         break;
 
+    case 't': case 'T':  // Make thin archive that refers to the object files
+        cmd.LibrarySubtype = LIBTYPE_THIN;
+        break;
+
+    case 'r': case 'R':  // Reproducible library: no time stamps
+        cmd.Deterministic = 1;
+        break;
+
+    case 'f': case 'F':  // Find members that define symbols, using the library symbol index
+        if (name1) {
+            cmd.LibraryOptions = CMDL_LIBRARY_FINDSYMBOL;
+            sym.Action  = SYMA_FIND_SYMBOL;
+            // Several symbol names may be separated by commas
+            while (name1) {
+                name2 = strchr(name1, ',');
+                if (name2) *(name2++) = 0;
+                if (*name1) {
+                    sym.Name1 = name1;  sym.Name2 = 0;
+                    SymbolList.Push(&sym, sizeof(sym));
+                }
+                name1 = name2;
+            }
+        }
+        else err.submit(2004, string);
+        break;
+
     default:
         err.submit(2004, string);  // Unknown option
     }
@@ -743,6 +798,36 @@ void CCommandLineInterpreter::InterpretSymbolNameChangeOption(char * string) {
     }
 }
 
+void CCommandLineInterpreter::InterpretDisasmSelectOption(char * string) {
+    // Interpret -dfunc option for selective disassembly.
+    // -dfunc:NAME selects the function containing symbol NAME.
+    // -dfunc:ADDR or -dfunc:ADDR1-ADDR2 selects the functions containing
+    // hexadecimal address ADDR or overlapping the range ADDR1 - ADDR2 (exclusive).
+    // Addresses are as shown in the disassembly listing
+    SDisasmSelect sel = {0,0,0,0,0};              // Selection record
+    char * end;                                   // End of number
+
+    if (*string == 0) {
+        err.submit(2004, string-6);  return;       // Empty name
+    }
+    sel.Name = string;
+    if (*string >= '0' && *string <= '9') {
+        // Address or address range. Only the low 32 bits are used, as in the listing
+        sel.Type = 1;
+        sel.Start = (uint32_t)strtoull(string, &end, 16);
+        sel.End = sel.Start + 1;
+        if (*end == '-' && end[1]) {
+            // Address range
+            sel.End = (uint32_t)strtoull(end + 1, &end, 16);
+        }
+        if ((*end | 0x20) == 'h') end++;          // Hexadecimal number may end with 'H'
+        if (*end || sel.End <= sel.Start) {
+            err.submit(2004, string-6);  return;   // Syntax error
+        }
+    }
+    DisasmSelect.Push(&sel, sizeof(sel));
+}
+
 void CCommandLineInterpreter::InterpretImagebaseOption(char * string) {
     // Interpret image base option
     char * p = strchr(string, '=');
@@ -815,6 +900,28 @@ SSymbolChange const * CCommandLineInterpreter::GetMemberToAdd() {
 }
 
 
+SSymbolChange const * CCommandLineInterpreter::GetLibraryRequest(int Action) {
+    // Get next symbol or member name with the specified library action,
+    // SYMA_FIND_SYMBOL or SYMA_EXTRACT_MEMBER
+
+    // Search through SymbolList, continuing from last CurrentSymbol
+    while (CurrentSymbol < SymbolList.GetDataSize()) {
+        // Get pointer to current symbol record
+        SSymbolChange * Sym = (SSymbolChange *)(SymbolList.Buf() + CurrentSymbol);
+        // Increment pointer
+        CurrentSymbol += sizeof(SSymbolChange);
+        // Check record type
+        if (Sym->Action == Action) {
+            // Name found
+            return Sym;
+        }
+    }
+    // No more names found. Reset pointer for next search
+    CurrentSymbol = 0;
+    return 0;
+}
+
+
 void CCommandLineInterpreter::CheckExtractSuccess() {
     // Check if library members to extract were found
 
@@ -847,6 +954,19 @@ void CCommandLineInterpreter::CheckSymbolModifySuccess() {
 }
 
 
+uint32_t CCommandLineInterpreter::TimeStamp() {
+    // Get time stamp for file headers and library member headers.
+    // Option -lr gives reproducible output: the time stamp is taken from the
+    // environment variable SOURCE_DATE_EPOCH if defined, otherwise zero
+    if (Deterministic) {
+        char * epoch = getenv("SOURCE_DATE_EPOCH");
+        if (epoch) return (uint32_t)strtoul(epoch, 0, 10);
+        return 0;
+    }
+    return (uint32_t)time(0);
+}
+
+
 int CCommandLineInterpreter::SymbolIsInList(char const * name) {
     // Check if name is already in symbol list
     int isym, nsym = SymbolList.GetNumEntries();
@@ -990,6 +1110,11 @@ int CCommandLineInterpreter::SymbolChange(char const * oldname, char const ** ne
                 // Ignore action for symbols that have the same name as a library member
                 action = SYMA_NOCHANGE;
             }
+            break;
+
+        case SYMA_FIND_SYMBOL:
+            // Symbol search in library index does not change anything
+            action = SYMA_NOCHANGE;
         }
 
         if (action && (psym->Action & SYMA_ALIAS)) {
@@ -1140,9 +1265,15 @@ void CCommandLineInterpreter::CountSymbolsHidden() {
 }
 
 
+void CCommandLineInterpreter::CountSectionsCollected() {
+    // Count sections removed because they are not referenced
+    CountUnreferencedSectionsRemoved++;
+}
+
+
 void CCommandLineInterpreter::ReportStatistics() {
     // Report statistics about name changes etc.
-    if (DebugInfo == CMDL_DEBUG_STRIP || ExeptionInfo == CMDL_EXCEPTION_STRIP 
+    if (DebugInfo == CMDL_DEBUG_STRIP || ExeptionInfo == CMDL_EXCEPTION_STRIP || SectionGC
         || Underscore || SegmentDot || SymbolList.GetNumEntries()) {
             printf ("\n");
     }
@@ -1152,7 +1283,10 @@ void CCommandLineInterpreter::ReportStatistics() {
     if (ExeptionInfo == CMDL_EXCEPTION_STRIP) {
         printf ("\n%3i Exception sections removed", CountExceptionSectionsRemoved);
     }
-    if ((DebugInfo == CMDL_DEBUG_STRIP || ExeptionInfo == CMDL_EXCEPTION_STRIP) 
+    if (SectionGC) {
+        printf ("\n%3i Unreferenced sections removed", CountUnreferencedSectionsRemoved);
+    }
+    if ((DebugInfo == CMDL_DEBUG_STRIP || ExeptionInfo == CMDL_EXCEPTION_STRIP || SectionGC) 
         && CountUnusedSymbolsHidden) {
             printf ("\n%3i Unused external symbol references hidden", CountUnusedSymbolsHidden);
     }
@@ -1191,7 +1325,11 @@ void CCommandLineInterpreter::Help() {
     printf("\n\nOptions:");
     printf("\n-fXXX[SS]  Output file format XXX, word size SS. Supported formats:");
     printf("\n           PE, COFF, ELF, OMF, MACHO\n");
-    printf("\n-fasm      Disassemble file (-fmasm, -fnasm, -fyasm, -fgasm)\n");
+    printf("\n-fasm      Disassemble file (-fmasm, -fnasm, -fyasm, -fgasm)");
+    printf("\n-fjson     Disassemble to instruction records, JSON Lines (-fbin: packed binary)");
+    printf("\n-fstat     Count instructions by mnemonic, instruction set, prefix and function");
+    printf("\n-dfunc:N   Output only symbol N or the function containing it.");
+    printf("\n           Hexadecimal address: -dfunc:0xN, range: -dfunc:0xN1-0xN2.\n");
     printf("\n-dXXX      Dump file contents to console.");
     printf("\n           Values of XXX (can be combined):");
     printf("\n           f: File header, h: section Headers, s: Symbol table,");
@@ -1212,13 +1350,18 @@ void CCommandLineInterpreter::Help() {
     //printf("\n-ds        Strip Debug info.");    // default if input and output are different formats
     //printf("\n-dp        Preserve Debug info, even if it is incompatible.");
     printf("\n-xs        Strip exception handling info and other incompatible info.");  // default if input and output are different formats. Hides unused symbols
-    printf("\n-xp        Preserve exception handling info and other incompatible info.\n");
+    printf("\n-xp        Preserve exception handling info and other incompatible info.");
+    printf("\n-gc        Garbage Collect sections not reachable from public symbols (ELF to COFF only).");
+    printf("\n-sm        Suffix Merge: store names in string tables only once if tail of another name.\n");
 
     printf("\n-lx        eXtract all members from Library.");
     printf("\n-lx:N1:N2  eXtract member N1 from Library to file N2.");
     printf("\n-ld:N1     Delete member N1 from Library.");
     printf("\n-la:N1:N2  Add object file N1 to Library as member N2.");
-    printf("\n           Alternative: -lib LIBRARYNAME OBJECTFILENAMES.\n");
+    printf("\n           Alternative: -lib LIBRARYNAME OBJECTFILENAMES.");
+    printf("\n-lt        make Thin library that refers to the object files (ELF only).");
+    printf("\n-lr        make Reproducible library with zero time stamps.");
+    printf("\n-lf:N1,N2  Find library members defining symbols N1, N2 from the symbol index.\n");
 
     printf("\n-vN        Verbose options. Values of N:");
     printf("\n           0: Silent, 1: Print file names and types, 2: Tell about conversions.");
@@ -28,6 +28,9 @@
 #define SUBTYPE_MASM                 0       // Disassembly MASM/TASM
 #define SUBTYPE_NASM                 1       // Disassembly NASM/YASM
 #define SUBTYPE_GASM                 2       // Disassembly GAS(Intel)
+#define SUBTYPE_JSON                 3       // Disassembly as structured records, JSON Lines
+#define SUBTYPE_BINREC               4       // Disassembly as structured records, packed binary
+#define SUBTYPE_STAT                 5       // Disassembly as instruction statistics
 
 // Constants for verbose or silent console output
 #define CMDL_VERBOSE_NO              0     // Silent. No console output if no errors or warnings
@@ -74,6 +77,7 @@
 #define CMDL_LIBRARY_ADDMEMBER       2     // Add object file to library
 #define CMDL_LIBRARY_EXTRACTMEM  0x100     // Extract specified object file(s) from library
 #define CMDL_LIBRARY_EXTRACTALL  0x110     // Extract all object files from library
+#define CMDL_LIBRARY_FINDSYMBOL  0x200     // Find library members that define specified symbols
 
 // Constants for file input/output options
 #define CMDL_FILE_INPUT              1     // Input file required
@@ -104,6 +108,7 @@
 #define SYMA_ADD_MEMBER         0x1001     // Add member to library
 #define SYMA_DELETE_MEMBER      0x1002     // Remove member from library
 #define SYMA_EXTRACT_MEMBER     0x1004     // Extract member from library
+#define SYMA_FIND_SYMBOL        0x1008     // Find public symbol in library symbol index
 
 // Structure for specifying desired change of a specific symbol
 struct SSymbolChange {
@@ -113,6 +118,15 @@ struct SSymbolChange {
    int    Done;                            // Count how many times this has been done
 };
 
+// Structure for selecting functions to disassemble with -dfunc option
+struct SDisasmSelect {
+   char * Name;                            // Symbol name or address range as written on command line
+   uint32_t Start;                         // Start address, as shown in disassembly (if Type = 1)
+   uint32_t End;                           // End address, exclusive (if Type = 1)
+   int    Type;                            // 0 = symbol name, 1 = address range
+   int    Done;                            // Count how many functions have been selected by this entry
+};
+
 // Class for interpreting command line
 class CCommandLineInterpreter {
 public:
@@ -126,9 +140,12 @@ public:
    void CountDebugRemoved();                 // Increment CountDebugSectionsRemoved
    void CountExceptionRemoved();             // Increment CountExceptionSectionsRemoved
    void CountSymbolsHidden();                // Increment CountUnusedSymbolsHidden
+   void CountSectionsCollected();            // Increment CountUnreferencedSectionsRemoved
    SSymbolChange const * GetMemberToAdd();   // Get names of object files to add to library
+   SSymbolChange const * GetLibraryRequest(int Action); // Get names of symbols to find or members to extract from library
    void CheckExtractSuccess();               // Check if library members to extract were found
    void CheckSymbolModifySuccess();          // Check if symbols to modify were found
+   uint32_t TimeStamp();                     // Time stamp for output file headers
    char * InputFile;                         // Input file name
    char * OutputFile;                        // Output file name
    int    InputType;                         // Input file type (detected from file)
@@ -140,13 +157,17 @@ public:
    uint32_t DumpOptions;                       // Options for dumping file
    uint32_t DebugInfo;                         // Strip or convert debug info
    uint32_t ExeptionInfo;                      // Strip or preserve exception handler info and other incompatible info
+   uint32_t SectionGC;                         // Remove sections not reachable from public symbols
+   uint32_t SuffixMerge;                       // Share tails of names in output string tables
    uint32_t Underscore;                        // Add/remove underscores in symbol names
    uint32_t SegmentDot;                        // Change underscore/dot in beginning of segment names
    uint32_t LibraryOptions;                    // Options for manipulating library
    uint32_t LibrarySubtype;                    // Options for manipulating library
+   uint32_t Deterministic;                     // Write zero time stamps for reproducible output
    uint32_t FileOptions;                       // Options for input and output files
    uint32_t ImageBase;                         // Specified image base
    int    ShowHelp;                          // Help screen printed
+   CMemoryBuffer DisasmSelect;               // Functions to disassemble. Contains entries of type SDisasmSelect. Empty = all
 protected:
    int  libmode;                             // -lib option has been encountered
    void ReadCommandItem(char *);             // Read one option from command line
@@ -162,6 +183,7 @@ protected:
    void InterpretSymbolNameChangeOption(char *);  // Interpret various options for changing symbol names
    void InterpretLibraryOption(char *);      // Interpret options for manipulating library/archive files
    void InterpretImagebaseOption(char *);    // Interpret image base option
+   void InterpretDisasmSelectOption(char *); // Interpret -dfunc option for selective disassembly
    void AddObjectToLibrary(char * filename, char * membername); // Add object file to library
    void Help();                              // Print help message
    CArrayBuf<CFileBuffer> ResponseFiles;     // Array of up to 10 response file buffers
@@ -181,6 +203,7 @@ protected:
    int CountUnusedSymbolsHidden;             // Count number of times unused symbols are hidden
    int CountDebugSectionsRemoved;            // Count number of debug sections removed
    int CountExceptionSectionsRemoved;        // Count number of exception handler sections removed
+   int CountUnreferencedSectionsRemoved;     // Count number of unreferenced sections removed by -gc
 };
 
 extern CCommandLineInterpreter cmd;          // Command line interpreter
@@ -46,6 +46,7 @@ void CCOF2COF::MakeSymbolTable() {
 
    // Initialize new string table. Make space for size
    NewStringTable.Push(0, 4);
+   NewStringTable.SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of long names
 
    // Loop through source symbol table
    OldSymtab.p = SymbolTable;  // Pointer to source symbol table
@@ -148,10 +149,8 @@ void CCOF2COF::MakeSymbolTable() {
          memset(AliasEntry.s.Name, 0, 8);
          if (strlen(name2) > 8) {
             // Long name. use string table
-            // Store string table offset
-            ((uint32_t *)(AliasEntry.s.Name))[1] = NewStringTable.GetDataSize();
-            // Put name into new string table
-            NewStringTable.PushString(name2);
+            // Put name into new string table and store string table offset
+            ((uint32_t *)(AliasEntry.s.Name))[1] = NewStringTable.PushString(name2);
          }
          else {
            // Short name. Store in record
@@ -173,10 +172,8 @@ void CCOF2COF::MakeSymbolTable() {
             uint32_t * LongNameStorage = (uint32_t *)(OldSymtab.p->s.Name);
             // Start with 0 to indicate long name
             LongNameStorage[0] = 0;
-            // Index into new string table
-            LongNameStorage[1] = NewStringTable.GetDataSize();
-            // Put name into new string table
-            NewStringTable.PushString(name3);
+            // Put name into new string table and store index
+            LongNameStorage[1] = NewStringTable.PushString(name3);
          }
          else {
             if (name3 != name1) {
@@ -210,10 +207,7 @@ void CCOF2COF::MakeSymbolTable() {
       }
       else {
          // Long name. Store in string table
-         sprintf(pSectHeader->Name, "/%i", NewStringTable.GetDataSize());
-         //pSectHeader->Name[0] = '/';
-         //itoa(NewStringTable.GetDataSize(), pSectHeader->Name+1, 10);
-         NewStringTable.PushString(name1);
+         sprintf(pSectHeader->Name, "/%i", NewStringTable.PushString(name1));
       }
    }
 }
@@ -226,15 +220,29 @@ void CCOF2COF::MakeBinaryFile() {
    // New file header = copy of old file header
    SCOFF_FileHeader NewFileHeader = *FileHeader;
 
-   ToFile.SetFileType(FILETYPE_COFF); // Set type of output file
-   ToFile.WordSize = WordSize;
-   ToFile.FileName = FileName;
+   // Find end of old string table
+   uint32_t EndOfOldStringTable = FileHeader->PSymbolTable 
+      + NumberOfSymbols * SIZE_SCOFF_SymTableEntry + StringTableSize;
+   uint32_t OldFileSize = GetDataSize();
+
+   if (OldFileSize <= EndOfOldStringTable) {
+      // Nothing after the string table. The symbol table has been modified in place.
+      // Take over old file buffer and cut off the old string table. 
+      // File header, section headers and sections are not copied
+      *this >> ToFile;
+      ToFile.SetSize(NewFileHeader.PSymbolTable + NumberOfSymbols * SIZE_SCOFF_SymTableEntry);
+   }
+   else {
+      ToFile.SetFileType(FILETYPE_COFF); // Set type of output file
+      ToFile.WordSize = WordSize;
+      ToFile.FileName = FileName;
 
-   // Copy file header, section headers and sections to new file
-   ToFile.Push(Buf(), NewFileHeader.PSymbolTable);
+      // Copy file header, section headers and sections to new file
+      ToFile.Push(Buf(), NewFileHeader.PSymbolTable);
 
-   // Copy symbol table
-   ToFile.Push(SymbolTable, NumberOfSymbols * SIZE_SCOFF_SymTableEntry);
+      // Copy symbol table
+      ToFile.Push(SymbolTable, NumberOfSymbols * SIZE_SCOFF_SymTableEntry);
+   }
 
    // Additions to symbol table
    int NumAddedSymbols = NewSymbolTable.GetNumEntries();
@@ -253,15 +261,12 @@ void CCOF2COF::MakeBinaryFile() {
    if (NewStringTableSize > 4) 
       ToFile.Push(NewStringTable.Buf() + 4, NewStringTableSize - 4);
 
-   // Find end of old and new string tables
-   uint32_t EndOfOldStringTable = FileHeader->PSymbolTable 
-      + NumberOfSymbols * SIZE_SCOFF_SymTableEntry + StringTableSize;
-
-   uint32_t EndOfNewStringTable = FileHeader->PSymbolTable 
+   // Find end of new string table
+   uint32_t EndOfNewStringTable = NewFileHeader.PSymbolTable 
       + (NumberOfSymbols + NumAddedSymbols) * SIZE_SCOFF_SymTableEntry + NewStringTableSize;
 
    // Check if there is anything after the string table
-   if (GetDataSize() > EndOfOldStringTable) {
+   if (OldFileSize > EndOfOldStringTable) {
       // Old file has something after the string table
 
       if (EndOfNewStringTable < EndOfOldStringTable) {
@@ -282,14 +287,14 @@ void CCOF2COF::MakeBinaryFile() {
          uint32_t SectionOffset = sizeof(SCOFF_FileHeader) + NewFileHeader.SizeOfOptionalHeader;
          for (i = 0; i < NSections; i++) {
             SCOFF_SectionHeader * pSectHeader;
-            pSectHeader = &Get<SCOFF_SectionHeader>(SectionOffset);
+            pSectHeader = &ToFile.Get<SCOFF_SectionHeader>(SectionOffset);
             SectionOffset += sizeof(SCOFF_SectionHeader);
-            if (pSectHeader->PRawData >= EndOfOldStringTable && pSectHeader->PRawData <= GetDataSize()) {
+            if (pSectHeader->PRawData >= EndOfOldStringTable && pSectHeader->PRawData <= OldFileSize) {
                pSectHeader->PRawData += EndOfNewStringTable - EndOfOldStringTable;
             }
-            if (pSectHeader->PRelocations >= EndOfOldStringTable && pSectHeader->PRawData <= GetDataSize()) {
+            if (pSectHeader->PRelocations >= EndOfOldStringTable && pSectHeader->PRawData <= OldFileSize) {
                pSectHeader->PRelocations += EndOfNewStringTable - EndOfOldStringTable;
-            }            if (pSectHeader->PLineNumbers >= EndOfOldStringTable && pSectHeader->PRawData <= GetDataSize()) {
+            }            if (pSectHeader->PLineNumbers >= EndOfOldStringTable && pSectHeader->PRawData <= OldFileSize) {
                pSectHeader->PLineNumbers += EndOfNewStringTable - EndOfOldStringTable;
             }
          }
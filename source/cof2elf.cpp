@@ -24,9 +24,12 @@ void CCOF2ELF<ELFSTRUCTURES>::Convert() {
    // Do the conversion
    NumSectionsNew = 5;                                    // Number of sections generated so far
 
+   // Find COMDAT sections. Each group needs a section
+   FindComdatSections();
+
    // Allocate variable size buffers
-   MaxSectionsNew    = NumSectionsNew + 2 * NSections;    // Max number of sections needed
-   NewSections.SetNum(MaxSectionsNew);                    // Allocate buffers for each section
+   MaxSectionsNew    = NumSectionsNew + NumGroups + 2 * NSections; // Max number of sections needed
+   NewSections.SetNum(NumSectionsNew);                    // Allocate buffers for symbol table and string tables
    NewSections.SetZero();                                 // Initialize
    NewSectionHeaders.SetNum(MaxSectionsNew);              // Allocate array for temporary section headers
    NewSectionHeaders.SetZero();                           // Initialize
@@ -39,19 +42,96 @@ void CCOF2ELF<ELFSTRUCTURES>::Convert() {
    ToFile.SetFileType(FILETYPE_ELF);   // Set type of to file
    MakeSegments();                     // Make segment headers and code/data segments
    MakeSymbolTable();                  // Symbol table and string tables
+   MakeLayout();                       // Section offsets and section data
    MakeRelocationTables();             // Relocation tables
+   MakeGroups();                       // Section groups for COMDAT sections
    MakeBinaryFile();                   // Putting sections together
    *this << ToFile;                    // Take over new file buffer
 }
 
 
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+void CCOF2ELF<ELFSTRUCTURES>::FindComdatSections() {
+   // Convert subfunction: Find COMDAT sections from their section definition records.
+   // Each COMDAT section that is not associative leads a section group. Associative 
+   // sections are put into the group of the section they are associated with
+   int isym;                           // Symbol table index
+   int numaux;                         // Number of auxiliary entries in source record
+   int sec;                            // Section index, 0-based
+   int leader;                         // Leader section, 0-based
+   int i;                              // Loop counter
+
+   ComdatLeader.SetNum(NSections);     ComdatLeader.SetZero();
+   ComdatSelection.SetNum(NSections);  ComdatSelection.SetZero();
+   ComdatSymbol.SetNum(NSections);     ComdatSymbol.SetZero();
+   ComdatSectionSymbol.SetNum(NSections); ComdatSectionSymbol.SetZero();
+   GroupSection.SetNum(NSections);     GroupSection.SetZero();
+   NumGroups = 0;
+
+   // Pointer to old symbol table
+   union {
+      SCOFF_SymTableEntry * p;         // Symtab entry pointer
+      int8_t * b;                        // Used for increment
+   } OldSymtab;
+
+   // Find section definition records and COMDAT symbols
+   OldSymtab.p = SymbolTable;
+   for (isym = 0; isym < NumberOfSymbols; isym += numaux+1, OldSymtab.b += SIZE_SCOFF_SymTableEntry*(numaux+1)) {
+      if (OldSymtab.b >= Buf() + DataSize) break;   // Error reported by MakeSymbolTable
+      numaux = OldSymtab.p->s.NumAuxSymbols;  if (numaux < 0) numaux = 0;
+      sec = OldSymtab.p->s.SectionNumber - 1;
+      if (sec < 0 || sec >= NSections || !(SectionHeaders[sec].Flags & PE_SCN_LNK_COMDAT)) continue;
+
+      if (numaux && OldSymtab.p->s.StorageClass == COFF_CLASS_STATIC && OldSymtab.p->s.Value == 0 
+      && OldSymtab.p->s.Type != 0x20 && ComdatSelection[sec] == 0) {
+         // Section definition record. Aux record has selection
+         SCOFF_SymTableEntry * sa = (SCOFF_SymTableEntry*)(OldSymtab.b + SIZE_SCOFF_SymTableEntry);
+         ComdatSelection[sec] = sa->section.Selection;
+         ComdatSectionSymbol[sec] = isym + 1;
+         if (sa->section.Selection == IMAGE_COMDAT_SELECT_ASSOCIATIVE) {
+            ComdatLeader[sec] = sa->section.Number;   // 1-based. Resolved below
+         }
+         else {
+            ComdatLeader[sec] = sec + 1;
+         }
+      }
+      else if (ComdatSelection[sec] && ComdatSymbol[sec] == 0) {
+         // First symbol after section definition is the COMDAT symbol
+         ComdatSymbol[sec] = isym + 1;
+      }
+   }
+
+   // Resolve chains of associative sections
+   for (sec = 0; sec < NSections; sec++) {
+      if (ComdatSelection[sec] != IMAGE_COMDAT_SELECT_ASSOCIATIVE) continue;
+      leader = ComdatLeader[sec] - 1;
+      for (i = 0; i < NSections && leader >= 0 && leader < NSections 
+      && ComdatSelection[leader] == IMAGE_COMDAT_SELECT_ASSOCIATIVE; i++) {
+         leader = ComdatLeader[leader] - 1;
+      }
+      if (leader < 0 || leader >= NSections || ComdatSelection[leader] == 0 
+      || ComdatSelection[leader] == IMAGE_COMDAT_SELECT_ASSOCIATIVE) {
+         ComdatLeader[sec] = 0;        // Not associated with a COMDAT group
+      }
+      else {
+         ComdatLeader[sec] = leader + 1;
+      }
+   }
+
+   // Count groups
+   for (sec = 0; sec < NSections; sec++) {
+      if (ComdatLeader[sec] == sec + 1) NumGroups++;
+   }
+}
+
+
 template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
 void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
    // Convert subfunction: Make segment headers and code/data segments
    TELF_SectionHeader NewSecHeader;    // New section header
    int oldsec;                         // Section index in old file
    int newsec;                         // Section index in new file
-   uint32_t SecNameIndex;                // Section name index into shstrtab
+   uint32_t SecNameIndex = 0;            // Section name index into shstrtab
    char const * SecName;               // Name of new section
    const int WordSize = sizeof(NewFileHeader.e_entry) * 8; // word size 32 or 64 bits
 
@@ -69,6 +149,7 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
    const int NumSpecialSegments = sizeof(SpecialSegmentNames)/sizeof(SpecialSegmentNames[0]);
 
    // Make first section header string table entry empty
+   NewSections[shstrtab].SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of names
    NewSections[shstrtab].PushString("");
 
    // Loop through special sections, except the first Null section:
@@ -112,6 +193,12 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
       err.submit(9000);
    }
 
+   // Section group headers must come before the member sections. 
+   // Headers are made below when the member sections are known
+   for (oldsec = 0; oldsec < this->NSections; oldsec++) {
+      if (ComdatLeader[oldsec] == oldsec + 1) GroupSection[oldsec] = newsec++;
+   }
+
    // Loop through source file sections
    for (oldsec = 0; oldsec < this->NSections; oldsec++) {
 
@@ -166,11 +253,6 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
       // Store section index in index translation table (zero-based index)
       NewSectIndex[oldsec] = newsec;
 
-      // Store section data
-      if (SectionHeader->SizeOfRawData > 0) {
-         NewSections[newsec].Push(Buf()+SectionHeader->PRawData, SectionHeader->SizeOfRawData);
-      }
-
       // Put data into new section header:
       // Initialize to zero
       memset(&NewSecHeader, 0, sizeof(NewSecHeader));
@@ -199,7 +281,19 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
          NewSecHeader.sh_flags = SHF_WRITE | SHF_ALLOC;
       }
 
-      // Put name into section header string table
+      // Name for relocation section = ".rel" or ".rela" + name of section
+      const int MAXSECTIONNAMELENGTH = 256;
+      char RelocationSectionName[MAXSECTIONNAMELENGTH] = ".rel";
+      if (WordSize == 64) strcat(RelocationSectionName, "a"); // 32-bit: .rel, 64-bit: .rela
+
+      strncat(RelocationSectionName, SecName, MAXSECTIONNAMELENGTH-5);
+      RelocationSectionName[MAXSECTIONNAMELENGTH-1] = 0;
+
+      // Put name into section header string table. With option -sm the longer 
+      // relocation section name is stored first so that the section name can share its tail
+      if (cmd.SuffixMerge && SectionHeader->NRelocations > 0) {
+         NewSections[shstrtab].PushString(RelocationSectionName);
+      }
       SecNameIndex = NewSections[shstrtab].PushString(SecName);
 
       // Put name into new section header
@@ -208,8 +302,8 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
       // Section virtual memory address
       NewSecHeader.sh_addr = SectionHeader->VirtualAddress;
 
-      // Section size in memory
-      NewSecHeader.sh_size = SectionHeader->VirtualSize;
+      // Section size in file. Data are copied by MakeLayout
+      NewSecHeader.sh_size = SectionHeader->SizeOfRawData;
 
       // Section alignment
       if (SectionHeader->Flags & PE_SCN_ALIGN_MASK) {
@@ -230,14 +324,6 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
          // Initialize to zero
          memset(&NewSecHeader, 0, sizeof(NewSecHeader));
 
-         // Name for relocation section = ".rel" or ".rela" + name of section
-         const int MAXSECTIONNAMELENGTH = 256;
-         char RelocationSectionName[MAXSECTIONNAMELENGTH] = ".rel";
-         if (WordSize == 64) strcat(RelocationSectionName, "a"); // 32-bit: .rel, 64-bit: .rela
-
-         strncat(RelocationSectionName, SecName, MAXSECTIONNAMELENGTH-5);
-         RelocationSectionName[MAXSECTIONNAMELENGTH-1] = 0;
-
          // Put name into section header string table
          uint32_t SecNameIndex = NewSections[shstrtab].PushString(RelocationSectionName);
 
@@ -247,6 +333,21 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
          // Section type
          NewSecHeader.sh_type = (WordSize == 32) ? SHT_REL : SHT_RELA;  // Relocation section
 
+         // Count relocations. Relocation types that have no equivalent in ELF are left out
+         uint32_t NumRelocations = 0;
+         if (uint64_t(SectionHeader->PRelocations) + uint64_t(SectionHeader->NRelocations) * SIZE_SCOFF_Relocation > GetDataSize()) {
+            err.submit(2035);                    // Relocation table outside file
+         }
+         else {
+            int8_t * OldReloc = Buf() + SectionHeader->PRelocations;
+            for (int i = 0; i < SectionHeader->NRelocations; i++, OldReloc += SIZE_SCOFF_Relocation) {
+               if (!IsNullRelocation(((SCOFF_Relocation*)OldReloc)->Type)) NumRelocations++;
+            }
+         }
+
+         // Size of relocation table. Entries are stored by MakeRelocationTables
+         NewSecHeader.sh_size = NumRelocations * ((WordSize == 32) ? sizeof(Elf32_Rel) : sizeof(Elf64_Rela));
+
          // Put section header into temporary buffer
          NewSectionHeaders[newsec] = NewSecHeader;
 
@@ -256,6 +357,30 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSegments() {
    }
    // Number of sections generated
    NumSectionsNew = newsec;
+
+   // Make section group headers
+   if (NumGroups) SecNameIndex = NewSections[shstrtab].PushString(".group");
+   for (oldsec = 0; oldsec < this->NSections; oldsec++) {
+      if (GroupSection[oldsec] == 0) continue;
+      memset(&NewSecHeader, 0, sizeof(NewSecHeader));
+      if (NewSectIndex[oldsec] != COFF_SECTION_REMOVE_ME) {
+         // Count member sections and their relocation sections
+         int NumMembers = 0;
+         for (int member = 0; member < this->NSections; member++) {
+            if (ComdatLeader[member] == oldsec + 1 && NewSectIndex[member] != COFF_SECTION_REMOVE_ME) {
+               NumMembers += 1 + (this->SectionHeaders[member].NRelocations > 0);
+            }
+         }
+         NewSecHeader.sh_name = SecNameIndex;
+         NewSecHeader.sh_type = SHT_GROUP;
+         NewSecHeader.sh_link = symtab;
+         NewSecHeader.sh_entsize = sizeof(uint32_t);
+         NewSecHeader.sh_addralign = sizeof(uint32_t);
+         NewSecHeader.sh_size = (NumMembers + 1) * sizeof(uint32_t);
+      }
+      // else: Leader has been removed. The reserved header is left as an empty SHT_NULL section
+      NewSectionHeaders[GroupSection[oldsec]] = NewSecHeader;
+   }
 }
 
 
@@ -281,6 +406,7 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeSymbolTable() {
    NewSections[symtab].Push(0, sizeof(TELF_Symbol));
 
    // Make first string table entries empty
+   NewSections[strtab] .SetSuffixMerge(cmd.SuffixMerge);
    NewSections[strtab] .PushString("");
    NewSections[stabstr].PushString("");
 
@@ -534,6 +660,14 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeRelocationTables() {
             int8_t * b;              // used for address calculation and incrementing
          } OldReloc;
 
+         // Relocation table outside file. Error has been reported by MakeSegments
+         if (uint64_t(SectionHeader->PRelocations) + uint64_t(SectionHeader->NRelocations) * SIZE_SCOFF_Relocation > GetDataSize()) {
+            continue;
+         }
+
+         // Number of relocations stored in new table
+         uint32_t NewRelocNum = 0;
+
          // Loop through relocations
 
          OldReloc.b = Buf() + SectionHeader->PRelocations;
@@ -689,16 +823,24 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeRelocationTables() {
                }
             }
 
+            // Relocations without ELF equivalent are left out of the table
+            if (IsNullRelocation(OldReloc.p->Type)) continue;
+
+            // Check that there is space in the table counted by MakeSegments
+            if ((NewRelocNum + 1) * NewRelTableSecHeader->sh_entsize > NewRelTableSecHeader->sh_size) {
+               err.submit(9000);  break;
+            }
+
             // Find inline addend
             int32_t * paddend = 0;
-            if (OldReloc.p->VirtualAddress + 4 > NewSections[newsec].GetDataSize()
+            if (OldReloc.p->VirtualAddress + 4 > NewSectionHeaders[newsec].sh_size
                || NewSectionHeaders[newsec].sh_type == SHT_NOBITS) {
                   // Address of relocation is invalid
                   err.submit(2032);
                }
             else {
                // Make pointer to inline addend
-               paddend = (int32_t*)(NewSections[newsec].Buf() 
+               paddend = (int32_t*)(ToFile.Buf() 
                   + NewSectionHeaders[newsec].sh_offset + OldReloc.p->VirtualAddress);
             } 
 
@@ -707,27 +849,36 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeRelocationTables() {
                if (NewRelocEntry.r_addend != 0) {
                   // Use inline addends in 32 bit ELF (SHT_REL)
                   // Put addend inline
-                  * paddend += uint32_t(NewRelocEntry.r_addend);
+                  if (paddend) * paddend += uint32_t(NewRelocEntry.r_addend);
                   NewRelocEntry.r_addend = 0;
                }
 
                // Save 32-bit relocation record Elf32_Rel, not Elf32_Rela
                if (NewRelocEntry.r_addend) err.submit(9000);
-               NewSections[newsecr].Push(&NewRelocEntry, sizeof(Elf32_Rel));
+               memcpy(ToFile.Buf() + NewRelTableSecHeader->sh_offset + NewRelocNum * sizeof(Elf32_Rel), &NewRelocEntry, sizeof(Elf32_Rel));
             }
             else {
-               // 64 bit
-               /*
-               if (*paddend != 0) {
-                  // Use explicit addend in 64 bit ELF (SHT_RELA)
-                  // Explicit addend may cause link error if it appears to point outside section
+               // 64 bit. The x86-64 linker ignores the inline field of a relocation 
+               // with explicit addend (SHT_RELA). Move the COFF inline addend into r_addend
+               if (paddend && NewRelocEntry.r_type == R_X86_64_64) {
+                  // 64-bit inline addend
+                  if (OldReloc.p->VirtualAddress + 8 > NewSectionHeaders[newsec].sh_size) {
+                     err.submit(2032);
+                  }
+                  else {
+                     NewRelocEntry.r_addend += *(int64_t*)paddend;
+                     *(int64_t*)paddend = 0;
+                  }
+               }
+               else if (paddend) {
                   NewRelocEntry.r_addend += *paddend;
                   *paddend = 0;
-               }*/
+               }
 
                // Save 64-bit relocation record. Must be Elf64_Rela
-               NewSections[newsecr].Push(&NewRelocEntry, sizeof(Elf64_Rela));
+               memcpy(ToFile.Buf() + NewRelTableSecHeader->sh_offset + NewRelocNum * sizeof(Elf64_Rela), &NewRelocEntry, sizeof(Elf64_Rela));
             }
+            NewRelocNum++;
          }
       }
    }
@@ -735,37 +886,128 @@ void CCOF2ELF<ELFSTRUCTURES>::MakeRelocationTables() {
 
 
 template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
-void CCOF2ELF<ELFSTRUCTURES>::MakeBinaryFile() {
-   // Convert subfunction: Make section headers and file header,
-   // and combine everything into a single memory buffer.
-   int32_t  newsec;              // Section index
+int CCOF2ELF<ELFSTRUCTURES>::IsNullRelocation(uint32_t Type) {
+   // Check if a COFF relocation type has no equivalent in ELF. 
+   // Such relocations would become R_386_NONE or R_X86_64_NONE, 
+   // so they are left out of the relocation table
+   const int WordSize = sizeof(NewFileHeader.e_entry) * 8; // word size 32 or 64 bits
+   if (WordSize == 32) {
+      return Type == COFF32_RELOC_ABS || Type == COFF32_RELOC_SECTION
+         || Type == COFF32_RELOC_SECREL || Type == COFF32_RELOC_SECREL7;
+   }
+   else {
+      return Type == COFF64_RELOC_ABS || Type == COFF64_RELOC_SECTION
+         || Type == COFF64_RELOC_SECREL || Type == COFF64_RELOC_SECREL7;
+   }
+}
+
+
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+void CCOF2ELF<ELFSTRUCTURES>::MakeLayout() {
+   // Convert subfunction: Compute the file offset of each section from the sizes
+   // already known, allocate the file once, and put section data directly into it.
+   // Relocation entries are stored into their place by MakeRelocationTables.
+   int32_t  newsec;              // Section index in new file
+   int32_t  oldsec;              // Section index in old file
    uint32_t SecOffset;           // Section offset in file
    uint32_t SecSize;             // Section size in file
-   uint32_t SectionHeaderOffset; // File offset to section headers
+   const int NumSpecialSegments = stabstr + 1; // Sections built in NewSections
 
-   // Set file type in ToFile
-   ToFile.SetFileType(FILETYPE_ELF);
-   
-   // Make space for file header in ToFile, but don't fill data into it yet
-   ToFile.Push(0, sizeof(TELF_Header));
+   // First section comes after file header
+   SecOffset = sizeof(TELF_Header);
 
-   // Loop through new section buffers
+   // Loop through new section headers
    for (newsec = 0; newsec < NumSectionsNew; newsec++) {
 
-      // Size of section
-      SecSize = NewSections[newsec].GetDataSize();
-
-      // Put section into ToFile
-      SecOffset = ToFile.Push(NewSections[newsec].Buf(), SecSize);
+      // Size of symbol table and string tables is known now.
+      // Size of other sections has been set by MakeSegments
+      if (newsec < NumSpecialSegments) {
+         NewSectionHeaders[newsec].sh_size = NewSections[newsec].GetDataSize();
+      }
 
-      // Put size and offset into section header
+      // Put offset into section header
       NewSectionHeaders[newsec].sh_offset = SecOffset;
-      NewSectionHeaders[newsec].sh_size   = SecSize;
 
       // Align before next entry
-      ToFile.Align(16);
+      SecOffset = (SecOffset + uint32_t(NewSectionHeaders[newsec].sh_size) + 15) & uint32_t(-16);
    }
 
+   // Allocate buffer for the whole file, including section headers
+   ToFile.SetSize(SecOffset + NumSectionsNew * sizeof(TELF_SectionHeader));
+
+   // Make space for file header and sections
+   ToFile.Push(0, SecOffset);
+
+   // Copy symbol table and string tables
+   for (newsec = 0; newsec < NumSpecialSegments; newsec++) {
+      SecSize = NewSections[newsec].GetDataSize();
+      if (SecSize) {
+         memcpy(ToFile.Buf() + NewSectionHeaders[newsec].sh_offset, NewSections[newsec].Buf(), SecSize);
+      }
+   }
+
+   // Copy section data from old file. Uninitialized data are left as zeroes
+   for (oldsec = 0; oldsec < NSections; oldsec++) {
+      newsec = NewSectIndex[oldsec];
+      if (newsec == COFF_SECTION_REMOVE_ME) continue;
+      SCOFF_SectionHeader * SectionHeader = &this->SectionHeaders[oldsec];
+      if (SectionHeader->SizeOfRawData == 0 || (SectionHeader->Flags & PE_SCN_CNT_UNINIT_DATA)) continue;
+      if (SectionHeader->PRawData + SectionHeader->SizeOfRawData > GetDataSize() 
+      || SectionHeader->PRawData + SectionHeader->SizeOfRawData < SectionHeader->PRawData) {
+         err.submit(2035);                       // Section data outside file
+      }
+      else {
+         memcpy(ToFile.Buf() + NewSectionHeaders[newsec].sh_offset, Buf() + SectionHeader->PRawData, SectionHeader->SizeOfRawData);
+      }
+   }
+}
+
+
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+void CCOF2ELF<ELFSTRUCTURES>::MakeGroups() {
+   // Convert subfunction: Fill in section groups for COMDAT sections.
+   // Selection types other than "no duplicates" become COMDAT groups, where the 
+   // linker keeps the first group with a given signature
+   int32_t oldsec;                     // Leader section in old file
+   int32_t member;                     // Member section in old file
+   int32_t newsec;                     // Section index in new file
+   int32_t isym;                       // Old index of signature symbol
+
+   for (oldsec = 0; oldsec < NSections; oldsec++) {
+      if (GroupSection[oldsec] == 0 || NewSectionHeaders[GroupSection[oldsec]].sh_type != SHT_GROUP) continue;
+      TELF_SectionHeader & GroupHeader = NewSectionHeaders[GroupSection[oldsec]];
+      uint32_t * group = (uint32_t*)(ToFile.Buf() + GroupHeader.sh_offset);
+
+      // Signature is the COMDAT symbol, or the section symbol if there is none
+      isym = ComdatSymbol[oldsec] ? ComdatSymbol[oldsec] : ComdatSectionSymbol[oldsec];
+      if (isym) GroupHeader.sh_info = NewSymbolIndex[isym - 1];
+
+      // Group flags
+      *(group++) = (ComdatSelection[oldsec] == IMAGE_COMDAT_SELECT_NODUPLICATES) ? 0 : GRP_COMDAT;
+
+      // Member sections
+      for (member = 0; member < NSections; member++) {
+         if (ComdatLeader[member] != oldsec + 1) continue;
+         newsec = NewSectIndex[member];
+         if (newsec == COFF_SECTION_REMOVE_ME) continue;
+         *(group++) = newsec;
+         NewSectionHeaders[newsec].sh_flags |= SHF_GROUP;
+         if (this->SectionHeaders[member].NRelocations > 0) {
+            *(group++) = newsec + 1;
+            NewSectionHeaders[newsec + 1].sh_flags |= SHF_GROUP;
+         }
+      }
+   }
+}
+
+
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+void CCOF2ELF<ELFSTRUCTURES>::MakeBinaryFile() {
+   // Convert subfunction: Make section headers and file header.
+   // Section data have already been put into ToFile by MakeLayout
+   int32_t  newsec;              // Section index
+   uint32_t SectionHeaderOffset; // File offset to section headers
+
    // Start offset of section headers
    SectionHeaderOffset = ToFile.GetDataSize();
 
@@ -878,7 +878,7 @@ void CCOFF::PrintImportExport() {
 
 // Functions for manipulating COFF files
 
-uint32_t COFF_PutNameInSymbolTable(SCOFF_SymTableEntry & sym, const char * name, CMemoryBuffer & StringTable) {
+uint32_t COFF_PutNameInSymbolTable(SCOFF_SymTableEntry & sym, const char * name, CStringPool & StringTable) {
    // Function to put a name into SCOFF_SymTableEntry. 
    // Put name in string table if longer than 8 characters.
    // Returns index into StringTable if StringTable used
@@ -898,7 +898,7 @@ uint32_t COFF_PutNameInSymbolTable(SCOFF_SymTableEntry & sym, const char * name,
    return 0;
 }
 
-void COFF_PutNameInSectionHeader(SCOFF_SectionHeader & sec, const char * name, CMemoryBuffer & StringTable) {
+void COFF_PutNameInSectionHeader(SCOFF_SectionHeader & sec, const char * name, CStringPool & StringTable) {
    // Function to put a name into SCOFF_SectionHeader. 
    // Put name in string table if longer than 8 characters
    int len = (int)strlen(name);                  // Length of name
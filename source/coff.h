@@ -358,8 +358,8 @@ union SCOFF_SymTableEntry {
       uint16_t NumberOfRelocations;  // Line number in source file
       uint16_t NumberOfLineNumbers;
       uint32_t CheckSum;             // Pointer to line number entry
-      uint16_t Number;               // Symbol table index of next function
-      uint8_t  Selection;            // Unused
+      uint16_t Number;               // Section number of associated section for COMDAT
+      uint8_t  Selection;            // COMDAT selection type
       uint8_t  Unused1[3];
    } section;
 };
@@ -368,6 +368,15 @@ union SCOFF_SymTableEntry {
 // Use SIZE_SCOFF_SymTableEntry instead of sizeof(SCOFF_SymTableEntry)
 #define SIZE_SCOFF_SymTableEntry  18  // Size of SCOFF_SymTableEntry packed
 
+// values of section.Selection for COMDAT sections
+#define IMAGE_COMDAT_SELECT_NODUPLICATES    1
+#define IMAGE_COMDAT_SELECT_ANY             2
+#define IMAGE_COMDAT_SELECT_SAME_SIZE       3
+#define IMAGE_COMDAT_SELECT_EXACT_MATCH     4
+#define IMAGE_COMDAT_SELECT_ASSOCIATIVE     5
+#define IMAGE_COMDAT_SELECT_LARGEST         6
+#define IMAGE_COMDAT_SELECT_NEWEST          7
+
 // values of weak.Characteristics
 #define IMAGE_WEAK_EXTERN_SEARCH_NOLIBRARY  1
 #define IMAGE_WEAK_EXTERN_SEARCH_LIBRARY    2
@@ -527,11 +536,11 @@ struct SCOFF_Relocation {
 
 // Function to put a name into SCOFF_SymTableEntry. Put name in string table
 // if longer than 8 characters
-uint32_t COFF_PutNameInSymbolTable(SCOFF_SymTableEntry & sym, const char * name, CMemoryBuffer & StringTable);
+uint32_t COFF_PutNameInSymbolTable(SCOFF_SymTableEntry & sym, const char * name, CStringPool & StringTable);
 
 // Function to put a name into SCOFF_SectionHeader. Put name in string table
 // if longer than 8 characters
-void COFF_PutNameInSectionHeader(SCOFF_SectionHeader & sec, const char * name, CMemoryBuffer & StringTable);
+void COFF_PutNameInSectionHeader(SCOFF_SectionHeader & sec, const char * name, CStringPool & StringTable);
 
 
 #endif // #ifndef PECOFF_H
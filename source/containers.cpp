@@ -63,7 +63,9 @@ void CMemoryBuffer::SetSize(uint32_t size) {
         return;
     }
     if (size < DataSize) {
-        // Request to delete some data
+        // Request to delete some data. 
+        // Clear it so that space after DataSize is always zero, as Push(0, n) and Align expect
+        memset(buffer + size, 0, DataSize - size);
         DataSize = size;
         return;
     }
@@ -168,6 +170,82 @@ void CMemoryBuffer::Align(uint32_t a) {
     DataSize = NewOffset;
 }
 
+// Members of class CStringPool
+CStringPool::CStringPool() : CMemoryBuffer() {
+    // Constructor
+    HashSize = HashUsed = 0;
+    SuffixMerge = 0;
+}
+
+uint32_t CStringPool::Hash(char const * s, uint32_t len) {
+    // Hash of string. The string is read backwards so that the hashes of all
+    // suffixes are found in the same loop when suffix merging
+    uint32_t hash = 0;
+    while (len) hash = hash * 31 + (uint8_t)s[--len];
+    return hash;
+}
+
+int32_t CStringPool::Find(char const * s, uint32_t hash) {
+    // Find string in table, return offset or -1 if not found
+    if (HashSize == 0) return -1;
+    uint32_t * Table = (uint32_t*)HashTable.Buf();
+    uint32_t i = hash & (HashSize - 1);
+    while (Table[i]) {
+        if (strcmp((char*)Buf() + Table[i] - 1, s) == 0) return Table[i] - 1; // Found
+        i = (i + 1) & (HashSize - 1);               // Next entry
+    }
+    return -1;                                      // Not found
+}
+
+void CStringPool::Insert(uint32_t Offset, uint32_t hash) {
+    // Insert string offset in hash table
+    uint32_t * Table;                               // Hash table entries
+    uint32_t i;                                     // Hash table index
+    if ((HashUsed + 1) * 2 > HashSize) {
+        // Table more than half full. Make new table of double size
+        uint32_t OldSize = HashSize;
+        CMemoryBuffer OldTable;
+        OldTable.Push(HashTable.Buf(), OldSize * sizeof(uint32_t));
+        HashSize = OldSize ? OldSize * 2 : 256;
+        HashTable.SetSize(0);
+        HashTable.Push(0, HashSize * sizeof(uint32_t));
+        Table = (uint32_t*)HashTable.Buf();
+        // Rehash old entries
+        for (uint32_t j = 0; j < OldSize; j++) {
+            uint32_t e = ((uint32_t*)OldTable.Buf())[j];
+            if (e == 0) continue;
+            char * s = (char*)Buf() + e - 1;
+            i = Hash(s, (uint32_t)strlen(s)) & (HashSize - 1);
+            while (Table[i]) i = (i + 1) & (HashSize - 1);
+            Table[i] = e;
+        }
+    }
+    Table = (uint32_t*)HashTable.Buf();
+    i = hash & (HashSize - 1);
+    while (Table[i]) i = (i + 1) & (HashSize - 1);
+    Table[i] = Offset + 1;
+    HashUsed++;
+}
+
+uint32_t CStringPool::PushString(char const * s) {
+    // Add ASCIIZ string to table if not already there, return offset
+    uint32_t len = (uint32_t)strlen(s);             // Length of string
+    uint32_t hash = Hash(s, len);                   // Hash of whole string
+    int32_t  Found = Find(s, hash);                 // Search for existing string
+    if (Found >= 0) return Found;                   // Reuse existing string
+    uint32_t Offset = CMemoryBuffer::PushString(s); // Store new string
+    Insert(Offset, hash);
+    if (SuffixMerge && len > 1) {
+        // Insert all suffixes that are not already in the table
+        hash = 0;
+        for (uint32_t i = len - 1; i > 0; i--) {
+            hash = hash * 31 + (uint8_t)s[i];        // Hash of suffix starting at i
+            if (Find(s + i, hash) < 0) Insert(Offset + i, hash);
+        }
+    }
+    return Offset;
+}
+
 // Members of class CFileBuffer
 CFileBuffer::CFileBuffer() : CMemoryBuffer() {  
     // Default constructor
@@ -281,8 +359,9 @@ int CFileBuffer::GetFileType() {
 
     uint32_t namelen = FileName ? (uint32_t)strlen(FileName) : 0;
 
-    if (strncmp((char*)Buf(),"!<arch>",7) == 0) {
-        // UNIX style library. Contains members of file type COFF, ELF or MACHO
+    if (strncmp((char*)Buf(),"!<arch>",7) == 0 || strncmp((char*)Buf(),"!<thin>",7) == 0) {
+        // UNIX style library. Contains members of file type COFF, ELF or MACHO.
+        // A thin archive contains only the headers and paths of the members
         FileType = FILETYPE_LIBRARY;
     }
     else if (strncmp((char*)Buf(),ELFMAG,4) == 0) {
@@ -449,7 +528,18 @@ char * CFileBuffer::SetFileNameExtension(const char * f) {
     }
     // Get default extension
     if (cmd.OutputType == FILETYPE_ASM) {
-        strcpy(name+i, ".asm"); // Assembly file
+        if (cmd.SubType == SUBTYPE_JSON) {
+            strcpy(name+i, ".json"); // Instruction records, JSON Lines
+        }
+        else if (cmd.SubType == SUBTYPE_BINREC) {
+            strcpy(name+i, ".bin");  // Instruction records, binary
+        }
+        else if (cmd.SubType == SUBTYPE_STAT) {
+            strcpy(name+i, ".txt");  // Instruction statistics
+        }
+        else {
+            strcpy(name+i, ".asm"); // Assembly file
+        }
     }
     else if (cmd.OutputType == FILETYPE_COFF || cmd.OutputType == FILETYPE_OMF) {
         if ((FileType & (FILETYPE_LIBRARY | FILETYPE_OMFLIBRARY)) || (cmd.LibraryOptions & CMDL_LIBRARY_ADDMEMBER)) {
@@ -558,8 +648,8 @@ void CFileBuffer::GetOMFWordSize() {
 // Constructor
 CTextFileBuffer::CTextFileBuffer() {
     column = 0;
-    // Use UNIX linefeeds only if GASM output
-    LineType = (cmd.SubType == SUBTYPE_GASM) ? 1 : 0;
+    // Use UNIX linefeeds only if GASM or JSON output
+    LineType = (cmd.SubType == SUBTYPE_GASM || cmd.SubType == SUBTYPE_JSON) ? 1 : 0;
 }
 
 void CTextFileBuffer::Put(const char * text) {
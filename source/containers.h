@@ -117,6 +117,26 @@ protected:
 static inline void operator << (CFileBuffer & b, CFileBuffer & a) {a >> b;} // Same as operator << above
 
 
+// Class CStringPool is used for building string tables in output files.
+// Identical strings are stored only once. With suffix merging enabled, a
+// string that is the tail of a string already in the table is not stored
+// but referenced by an offset into the longer string.
+class CStringPool : public CMemoryBuffer {
+public:
+   CStringPool();                                // Constructor
+   uint32_t PushString(char const * s);          // Add ASCIIZ string to table if not already there, return offset
+   void SetSuffixMerge(int m) {SuffixMerge = m;} // Enable or disable suffix merging for strings added later
+protected:
+   CMemoryBuffer HashTable;                      // Hash table of uint32_t offset + 1 of each string. 0 = vacant
+   uint32_t HashSize;                            // Number of entries in HashTable, a power of 2
+   uint32_t HashUsed;                            // Number of used entries in HashTable
+   int SuffixMerge;                              // Suffixes of added strings can be shared
+   int32_t Find(char const * s, uint32_t hash);  // Find string in table, return offset or -1
+   void Insert(uint32_t Offset, uint32_t hash);  // Insert string offset in hash table
+   static uint32_t Hash(char const * s, uint32_t len); // Hash of string of length len
+};
+
+
 // Class CFileBuffer is used for storage of input and output files
 class CFileBuffer : public CMemoryBuffer {
 public:
@@ -138,6 +138,7 @@ class COMF : public CFileBuffer {
 public:
    COMF();                                       // Default constructor
    void ParseFile();                             // Parse file buffer
+   void CheckChecksums();                        // Verify record checksums. Call after ParseFile
    void Dump(int options);                       // Dump file
    void PublicNames(CMemoryBuffer * Strings, CSList<SStringEntry> * Index, int m); // Make list of public names
 protected:
@@ -148,6 +149,8 @@ protected:
    CSList<uint32_t> SegmentNameOffset;             // Offset into NameBuffer of segment names by segment index
    CSList<uint32_t> SymbolNameOffset;              // Offset into NameBuffer of external symbol names
    CSList<uint32_t> GroupNameOffset;               // Offset into NameBuffer of group names
+   CSList<uint32_t> SegmentFirstRecord;            // First LEDATA, LIDATA or FIXUPP record for each segment index, 0 if none
+   CSList<uint32_t> NextSegmentRecord;             // Next data or FIXUPP record for same segment, by record index. 0 = end of list
    char * GetLocalName(uint32_t i);                // Get segment name by name index
    uint32_t GetLocalNameO(uint32_t i);               // Get segment name by converting name index offset into NameBuffer
    const char * GetSegmentName(uint32_t i);        // Get segment name by segment index
@@ -208,15 +211,25 @@ public:
 protected:
    void MakeSegments();                           // Convert subfunction: Segments
    void MakeSymbolTable();                        // Convert subfunction: Symbol table and string tables
+   void MakeLayout();                             // Convert subfunction: Section offsets and section data
    void MakeRelocationTables();                   // Convert subfunction: Relocation tables
+   void FindComdatSections();                     // Convert subfunction: Find COMDAT sections and their groups
+   void MakeGroups();                             // Convert subfunction: Section groups for COMDAT sections
    void MakeBinaryFile();                         // Convert subfunction: Putting sections together
+   int  IsNullRelocation(uint32_t Type);          // Check if relocation type has no equivalent in ELF
    int symtab;                                    // Symbol table section number
    int shstrtab;                                  // Section name string table section number
    int strtab;                                    // Object name string table section number
    int stabstr;                                   // Debug string table section number
    int NumSectionsNew;                            // Number of sections generated for 'to' file
    int MaxSectionsNew;                            // Number of section buffers allocated for 'to' file
-   CArrayBuf<CMemoryBuffer> NewSections;          // Buffers for building each section
+   int NumGroups;                                 // Number of section groups for COMDAT sections
+   CArrayBuf<int> ComdatLeader;                   // Leader of COMDAT group for each old section, 1-based. 0 if none
+   CArrayBuf<uint8_t> ComdatSelection;            // COMDAT selection type for each old section
+   CArrayBuf<int> ComdatSymbol;                   // Old index+1 of COMDAT symbol for each old section
+   CArrayBuf<int> ComdatSectionSymbol;            // Old index+1 of section definition symbol for each old section
+   CArrayBuf<int> GroupSection;                   // New index of group section for each leader section
+   CArrayBuf<CStringPool> NewSections;            // Buffers for symbol table and string tables
    CArrayBuf<TELF_SectionHeader> NewSectionHeaders;// Buffer for temporary section headers
    CArrayBuf<int> NewSectIndex;                   // Buffers for array of new section indices
    CArrayBuf<int> NewSymbolIndex;                 // Buffers for array of new symbol indices
@@ -273,7 +286,7 @@ protected:
    CFileBuffer ToFile;                           // File buffer for PE/COFF file
    CSList<SCOFF_SymTableEntry> NewSymbolTable;   // New symbol table entries
    CSList<SCOFF_SectionHeader> NewSectionHeaders;// New section headers
-   CMemoryBuffer NewStringTable;                 // Buffer for building new string table
+   CStringPool   NewStringTable;                 // Buffer for building new string table
    CMemoryBuffer NewData;                        // Raw data for each section in new file and its relocation table
    CSList<uint32_t> SegmentTranslation;            // Translate old segment number to new symbol table index
    CSList<uint32_t> ExtdefTranslation;             // Translate old external symbol number to new symbol table index
@@ -291,17 +304,22 @@ public:
 protected:
    void MakeFileHeader();                        // Convert subfunction: File header
    void MakeSectionsIndex();                     // Convert subfunction: Make section index translation table
+   void RemoveUnreferencedSections();            // Convert subfunction: Remove sections not reachable from public symbols
+   void FindComdatGroups();                      // Convert subfunction: Find COMDAT section groups
    void MakeSections();                          // Convert subfunction: Make sections and relocation tables
    void MakeSymbolTable();                       // Convert subfunction: Symbol table and string tables
+   void MakeComdatSymbols(int8_t * symtab, uint32_t NumSymbols, uint32_t entrysize, char * strtab, uint32_t stringtabsize); // Symbol records for COMDAT sections
    void HideUnusedSymbols();                     // Convert subfunction: Hide unused symbols
    void MakeBinaryFile();                        // Convert subfunction: Putting sections together
    int NumSectionsNew;                           // Number of sections in new file
    CArrayBuf<int32_t> NewSectIndex;                // Array of new section indices
    CArrayBuf<int32_t> SymbolsUsed;                 // Array of new symbol indices
+   CArrayBuf<uint32_t> ComdatLeader;               // Leader section of COMDAT group for each old section. 0 if none
+   CArrayBuf<uint32_t> ComdatSignature;            // Old index of signature symbol for each COMDAT leader section
+   CArrayBuf<uint32_t> ComdatSymbol;               // New index of section symbol for each COMDAT section
    CSList<int32_t> NewSymbolIndex;                 // Buffer for array of new symbol indices
    CMemoryBuffer NewSymbolTable;                 // Buffer for building new symbol table
-   CMemoryBuffer NewStringTable;                 // Buffer for building new string table
-   CMemoryBuffer NewRawData;                     // Buffer for building new raw data area
+   CStringPool   NewStringTable;                 // Buffer for building new string table
    uint32_t RawDataOffset;                         // File offset for raw data
    CFileBuffer ToFile;                           // File buffer for PE/COFF file
    SCOFF_FileHeader NewFileHeader;               // New file header
@@ -329,7 +347,7 @@ protected:
    CFileBuffer   ToFile;               // File buffer for new Mach-O file
    CMemoryBuffer NewRawData;           // Buffer for building new raw data area
    CMemoryBuffer NewRelocationTab;     // Buffer for new relocation tables
-   CMemoryBuffer NewStringTable;       // Buffer for building new string table
+   CStringPool   NewStringTable;       // Buffer for building new string table
    CMemoryBuffer UnnamedSymbolsTable;  // Buffer for assigning names to unnamed symbols
    CArrayBuf<int> NewSectIndex;        // Array of new section indices
    CArrayBuf<MInt> NewSectOffset;      // Array of new section offsets
@@ -372,13 +390,14 @@ protected:
    int FakeGOTSection;                            // Fake GOT section number
    int FakeGOTSymbol;                             // Symbol index for fake GOT
    TELF_Header NewFileHeader;                     // New file header
-   CArrayBuf<CMemoryBuffer> NewSections;          // Buffers for building each section
+   CArrayBuf<CStringPool> NewSections;            // Buffers for building each section
    CArrayBuf<TELF_SectionHeader> NewSectionHeaders;// Array of temporary section headers
    CArrayBuf<int> NewSectIndex;                   // Array of new section indices
    CArrayBuf<int> NewSymbolIndex;                 // Array of new symbol indices
    CArrayBuf<int> SectionSymbols;                 // Array of new symbol indices for sections
    CFileBuffer ToFile;                            // File buffer for ELF file
    CSList<int> GOTSymbols;                        // List of symbols needing GOT entry
+   CArrayBuf<uint32_t> GOTIndex;                  // GOT entry number + 1 for each new symbol. 0 if none
 };
 
 
@@ -391,7 +410,7 @@ protected:
    void MakeSymbolTable();                       // Convert subfunction: Symbol table and string tables
    void MakeBinaryFile();                        // Convert subfunction: Putting sections together
    CMemoryBuffer NewSymbolTable;                 // Buffers for building new symbol table
-   CMemoryBuffer NewStringTable;                 // Buffers for building new string table
+   CStringPool   NewStringTable;                 // Buffers for building new string table
    CFileBuffer ToFile;                           // File buffer for modified PE file
 };
 
@@ -406,10 +425,11 @@ protected:
    void MakeSymbolTable();                       // Convert subfunction: Symbol table and string tables
    void ChangeSections();                        // Convert subfunction: Change section names if needed
    void MakeBinaryFile();                        // Convert subfunction: Putting sections together
+   int  PatchBinaryFile();                       // Convert subfunction: Putting new tables into old file. Return 0 if success
    uint32_t isymtab[2];                            // static and dynamic symbol table section number
    uint32_t istrtab[4];                            // string table section number: symbols, dynamic symbols, sections, debug
    CMemoryBuffer NewSymbolTable[2];              // Buffers for building new symbol tables: static, dynamic
-   CMemoryBuffer NewStringTable[4];              // Buffers for building new string tables: symbols, dynamic symbols, sections, debug
+   CStringPool   NewStringTable[4];              // Buffers for building new string tables: symbols, dynamic symbols, sections, debug
    CArrayBuf<uint32_t> NewSymbolIndex;             // Array for translating old to new symbol indices
    uint32_t NumOldSymbols;                         // Size of NewSymbolIndex table
    uint32_t FirstGlobalSymbol;                     // Index to first global symbol in .symtab
@@ -433,7 +453,7 @@ protected:
    uint32_t NewFileOffset(uint32_t OldOffset);       // Convert subfunction: Translate old to new file offset
    MacSymbolTableBuilder<TMAC_nlist, MInt> NewSymbols[3];// Buffers for building new symbol tables: local, public, external
    CMemoryBuffer NewSymbolTable;                 // Buffer for building new symbol table
-   CMemoryBuffer NewStringTable;                 // Buffer for building new string table
+   CStringPool   NewStringTable;                 // Buffer for building new string table
    CFileBuffer ToFile;                           // File buffer for modified PE file
    uint32_t NumOldSymbols;                         // Size of NewSymbolIndex table
    uint32_t NewIlocalsym;	                         // index to local symbols
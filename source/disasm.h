@@ -551,6 +551,95 @@ struct SASymbol {
       return Section < y.Section || (Section == y.Section && Offset < y.Offset);}
 };
 
+// Structures for structured disassembly output in packed binary form (-fbin).
+// The file begins with SARecordFileHeader, followed by one SAInstructionRecord
+// for each instruction in the code sections, and then the section, function
+// and symbol tables and the string table. All offsets are from the beginning 
+// of the file. Names are offsets into the string table.
+struct SARecordFileHeader {
+   char     Magic[8];                            // "OBJCNVR1"
+   uint32_t HeaderSize;                          // Size of this header
+   uint32_t InstructionRecordSize;               // Size of each SAInstructionRecord
+   uint32_t NumInstructions;                     // Number of instruction records
+   uint32_t InstructionOffset;                   // Offset of instruction records
+   uint32_t NumSections;                         // Number of entries in section table
+   uint32_t SectionOffset;                       // Offset of section table
+   uint32_t NumFunctions;                        // Number of entries in function table
+   uint32_t FunctionOffset;                      // Offset of function table
+   uint32_t NumSymbols;                          // Number of entries in symbol table
+   uint32_t SymbolOffset;                        // Offset of symbol table
+   uint32_t StringTableSize;                     // Size of string table
+   uint32_t StringTableOffset;                   // Offset of string table
+   int64_t  ImageBase;                           // Image base, if executable file
+};
+
+struct SAInstructionRecord {
+   uint32_t Section;                             // Section number, index into section table
+   uint32_t Offset;                              // Offset of instruction into section
+   uint32_t Function;                            // Function number, index into function table. 0 if none
+   uint32_t Mnemonic;                            // Opcode name, without operand size suffix
+   uint16_t OpcodeId;                            // Map number and index in opcodes.cpp. Identifies the opcode table entry
+   uint8_t  Length;                              // Length of instruction in bytes
+   uint8_t  Flags;                               // 1 = dubious, possibly data, 2 = has warnings, 4 = has errors, 
+                                                 // 8 = Target is relocation target, 0x10 = Target is jump/call address
+   uint32_t Operands[5];                         // Operand types, as s.Operands. See SOpcodeDef for values
+   uint32_t Target;                              // Old index of relocation target in symbol table, or image-relative jump/call target address
+   int32_t  Addend;                              // Addend to relocation target
+   uint8_t  Bytes[16];                           // Instruction bytes. Only the first 16 bytes if longer
+};
+
+struct SARecordSection {
+   uint32_t Name;                                // Section name
+   uint32_t SectionAddress;                      // Image-relative address of section
+   uint32_t InitSize;                            // Size of initialized data in section
+   uint32_t TotalSize;                           // Size of initialized and uninitialized data in section
+   uint32_t Type;                                // As SASection::Type
+   uint32_t WordSize;                            // 16, 32 or 64
+};
+
+struct SARecordFunction {
+   int32_t  Section;                             // Section containing function
+   uint32_t Start;                               // Offset of function start
+   uint32_t End;                                 // Offset of function end
+   uint32_t Scope;                               // As SFunctionRecord::Scope
+   uint32_t Name;                                // Name of function, 0 if none
+};
+
+struct SARecordSymbol {
+   uint32_t OldIndex;                            // Symbol identifier used in SAInstructionRecord::Target
+   int32_t  Section;                             // Section number. 0 = external, -1 = absolute symbol
+   uint32_t Offset;                              // Offset into section. (Value for absolute symbol)
+   uint32_t Scope;                               // As SASymbol::Scope
+   uint32_t Name;                                // Name of symbol
+};
+
+// Structure for mnemonics used in structured output and statistics
+struct SAMnemonic {
+   SOpcodeDef const * OpcodeDef;                 // Entry in opcode map. 0 if undefined
+   uint32_t VEX;                                 // 1 if name has 'v' prefix for VEX encoding
+   uint32_t Suffix;                              // Prefixes and operand types that determine the suffix of the name
+   uint32_t Name;                                // Mnemonic, as offset into CDisassembler::RecordStrings
+   uint32_t Count;                               // Number of instructions (-fstat)
+   uint32_t Bytes;                               // Total size of these instructions (-fstat)
+   int operator < (const SAMnemonic & y) const { // Operator for sorting by opcode map entry
+      return (uintptr_t)OpcodeDef < (uintptr_t)y.OpcodeDef || (OpcodeDef == y.OpcodeDef 
+         && (VEX < y.VEX || (VEX == y.VEX && Suffix < y.Suffix)));}
+};
+
+// Structure for instruction statistics of one function (-fstat)
+struct SAFunctionStat {
+   uint32_t Instructions;                        // Number of instructions
+   uint32_t Bytes;                               // Size of instructions
+   uint32_t LegacySSE;                           // Number of SSE instructions without VEX prefix
+   uint32_t VEX;                                 // Number of instructions with VEX or XOP prefix
+   uint32_t EVEX;                                // Number of instructions with EVEX or MVEX prefix
+};
+
+// Make search key for sorting symbols by address. Gives the same order as SASymbol::operator <
+static inline uint64_t SymbolAddressKey(int32_t Section, uint32_t Offset) {
+   return (uint64_t)((uint32_t)Section ^ 0x80000000) << 32 | Offset;
+}
+
 // Define class CSymbolTable
 class CSymbolTable {
 public:
@@ -575,6 +664,10 @@ public:
    uint32_t GetNumEntries() {return List.GetNumEntries();}// Get highest new symbol number + 1
 protected:
    CSList<SASymbol> List;                        // List of symbols, sorted by address
+   CSList<uint64_t> AddressKeys;                 // Section:Offset of each entry in List, used for searching by address
+   uint32_t AddressCursor;                       // Result of last search in AddressKeys. Start point for next search
+   uint32_t FindAddressKey(uint64_t Key);        // Find first entry in AddressKeys >= Key
+   uint32_t PushSymbol(SASymbol const & sym);    // Insert symbol in List and AddressKeys
    CMemoryBuffer    SymbolNameBuffer;            // String buffer for names of symbols
    CSList<uint32_t>   TranslateOldIndex;           // Table to translate old symbol index to new symbol index
    void UpdateIndex();                           // Update TranslateOldIndex
@@ -658,6 +751,16 @@ protected:
    int64_t   ImageBase;                            // Image base for executable files
    uint32_t  ExeType;                              // File type: 0 = object, 1 = position independent shared object, 2 = executable
    uint32_t  RelocationsInSource;                  // Number of relocations in source file
+   uint32_t  RelocationCursor;                     // Result of last FindRelocation. Start point for next search
+   uint32_t  RecordFormat;                         // Structured output instead of assembly text: SUBTYPE_JSON, SUBTYPE_BINREC or SUBTYPE_STAT. 0 = none
+   CMemoryBuffer RecordStrings;                  // String table for binary record output
+   CSList<SAMnemonic> Mnemonics;                 // Mnemonics used, with names in RecordStrings
+   CArrayBuf<SAFunctionStat> FunctionStats;      // Statistics for each entry in FunctionList (-fstat)
+   CArrayBuf<uint32_t> InstructionSetCounts;     // Number of instructions for each instruction set (-fstat)
+   uint32_t  PrefixCounts[11];                     // Number of instructions with each kind of prefix (-fstat)
+   uint32_t  ErrorCounts[3][32];                   // Number of instructions with each bit in s.Errors, s.Warnings1, s.Warnings2 (-fstat)
+   CArrayBuf<uint8_t> SectionSelected;           // Sections selected by -dfunc option. Empty if no selection
+   CArrayBuf<SFunctionRecord> SelectedRange;     // Part of each entry in FunctionList selected by -dfunc option. End = 0 if not selected. Empty if no selection
 
    // Code parser: The following members are used for parsing 
    // an opcode and identifying its components
@@ -699,6 +802,7 @@ protected:
    int32_t   Assumes[6];                           // Assumed value of segment register es, cs, ss, ds, fs, gs. See CDisassembler::WriteSectionName for values
    void    Pass1();                              // Pass 1: Find symbols types and unnamed symbols
    void    Pass2();                              // Pass 2: Write output file
+   void    SelectFunctions();                    // Find functions selected by -dfunc option
    int     NextFunction2();                      // Loop through function blocks in pass 2. Return 0 if finished
    int     NextLabel();                          // Loop through labels. (Pass 2)
    int     NextInstruction1();                   // Go to next instruction. Return 0 if none. (Pass 1)
@@ -714,9 +818,11 @@ protected:
    void    FindLabels();                         // Find any labels at current position and next
    void    CheckForMisplacedLabel();             // Remove any label placed inside function
    void    FindRelocations();                    // Find any relocation sources in this instruction
+   uint32_t  FindRelocation(int32_t Sect, uint32_t Offset); // Find first relocation with source address >= Sect:Offset
    void    FindWarnings();                       // Find any reasons for warnings in code
    void    FindErrors();                         // Find any errors in code
    void    FindInstructionSet();                 // Update instruction set
+   uint16_t GetInstructionSet();                 // Get instruction set of current instruction
    void    CheckForNops();                       // Check if warnings are caused by multi-byte NOP
    void    UpdateSymbols();                      // Find unnamed symbols, determine symbol types, update symbol list, call CheckJumpTarget if jump/call
    void    UpdateTracer();                       // Trace register values
@@ -763,6 +869,18 @@ protected:
    void    WriteErrorsAndWarnings();             // Write errors and warnings, if any
    void    WriteAssume();                        // Write assume directive for segment register
    void    WriteInstruction();                   // Write instruction and operands
+   void    WriteOpcodeName(CTextFileBuffer & Out); // Write opcode name with prefix and suffix
+   void    WriteRecords();                       // Pass 2 for structured output: Write records instead of assembly text
+   void    WriteInstructionRecord();             // Write record for one instruction
+   void    WriteSectionRecordJSON();             // Write record for current section, JSON Lines
+   void    WriteFunctionRecordJSON();            // Write record for current function, JSON Lines
+   void    WriteRecordTables();                  // Write section, function, symbol and string tables after binary records
+   void    WriteJSONString(const char * s);      // Write quoted and escaped string
+   uint32_t RecordString(const char * s);        // Put string into RecordStrings
+   uint32_t FindMnemonic();                      // Find or add current mnemonic in Mnemonics
+   void    CountInstruction();                   // Update statistics for current instruction (-fstat)
+   void    WriteStatistics();                    // Write instruction statistics (-fstat)
+   void    PutDecimalRight(uint32_t x, uint32_t column); // Write right-aligned decimal number ending at column
    void    WriteCodeComment();                   // Write hex listing of instruction as comment after instruction
    void    WriteStringInstruction();             // Write string instruction or xlat instruction
    void    WriteShortRegOperand(uint32_t Type);    // Write register operand from lower 3 bits of opcode byte to OutFile
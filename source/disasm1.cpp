@@ -41,12 +41,20 @@ To access a symbol by its old index, you have to translate it with Old2NewIndex
 To access a symbol by its new index, use operator [].
 To find a symbol by its address, use FindByAddress().
 
+The addresses of all symbols are also kept in a separate array, AddressKeys,
+with the same order as List. Each entry is the section and offset packed
+into a 64-bit key. FindByAddress searches this compact array rather than the 
+full symbol records. Pass 1 and pass 2 search for addresses in ascending
+order, so the search starts at the point where the previous search ended and
+falls back to a binary search only if the new address is not nearby.
+
 ******************************************************************************/
 
 CSymbolTable::CSymbolTable() {
     // Constructor
     OldNum = 1;
     NewNum = 0;                                   // Initialize
+    AddressCursor = 0;                            // Start point for searching by address
     UnnamedNum = 0;                               // Number of unnamed symbols
     UnnamedSymFormat = 0;                         // Format string for giving names to unnamed symbols
     UnnamedSymbolsPrefix = cmd.SubType == SUBTYPE_GASM ? "$_" : "?_";// Prefix to add to unnamed symbols
@@ -56,7 +64,7 @@ CSymbolTable::CSymbolTable() {
     SASymbol sym0;
     sym0.Reset();
     sym0.Section = 0x80000000;                    // Lowest possible address
-    List.PushSort(sym0);                          // Put into Symbols list
+    PushSymbol(sym0);                             // Put into Symbols list
 
     SymbolNameBuffer.Push(0, 1);                  // Make string 0 empty
 }
@@ -109,7 +117,7 @@ uint32_t Type, uint32_t Scope, uint32_t OldIndex, const char * Name, const char
     }
     else {
         // Make unique entry
-        List.PushSort(NewSym);
+        PushSymbol(NewSym);
     }
 
     // Set OldNum to 1 + maximum OldIndex
@@ -157,7 +165,7 @@ uint32_t CSymbolTable::NewSymbol(SASymbol & sym) {
         // Give it an old index
         if (sym.OldIndex == 0) sym.OldIndex = OldNum++;
 
-        SIndex = List.PushSort(sym);
+        SIndex = PushSymbol(sym);
     }
 
     // Return new index
@@ -165,6 +173,38 @@ uint32_t CSymbolTable::NewSymbol(SASymbol & sym) {
 }
 
 
+uint32_t CSymbolTable::PushSymbol(SASymbol const & sym) {
+    // Insert symbol in List and keep AddressKeys in sync with List.
+    // The return value is the new index of the inserted symbol
+    uint32_t i = List.PushSort(sym);
+    // AddressKeys has the same sort order as List, so the key goes in at the same index
+    AddressKeys.PushSort(SymbolAddressKey(sym.Section, sym.Offset));
+    return i;
+}
+
+uint32_t CSymbolTable::FindAddressKey(uint64_t Key) {
+    // Returns index to first entry in AddressKeys >= Key, or the number of
+    // entries if Key is bigger than all entries. Same as AddressKeys.FindFirst(Key).
+    // Consecutive searches are mostly for increasing addresses close to each
+    // other. Try a few steps forward from the previous result before
+    // resorting to a binary search
+    uint32_t n = AddressKeys.GetNumEntries();    // Number of entries
+    uint64_t * k = &AddressKeys[0];              // List is never empty. Entry 0 is a dummy
+    uint32_t i = AddressCursor;                  // Start at previous result
+    uint32_t j;                                  // Step counter
+    if (i > n) i = n;                            // Entries may have been removed. (Not currently possible)
+    if (i == 0 || k[i-1] < Key) {
+        // The entry before i is below Key. Search forwards from i
+        for (j = 0; j < 8 && i < n && k[i] < Key; j++) i++;
+        if (i == n || !(k[i] < Key)) {
+            // Found within a few steps
+            return AddressCursor = i;
+        }
+    }
+    // Not near the previous position. Do a binary search
+    return AddressCursor = AddressKeys.FindFirst(Key);
+}
+
 uint32_t CSymbolTable::NewSymbol(int32_t Section, uint32_t Offset, uint32_t Scope) {
     // Add symbol to jump target or code block that doesn't have a name.
     // Will not add a new symbol if one already exists at this address.
@@ -249,24 +289,24 @@ uint32_t CSymbolTable::FindByAddress(int32_t Section, uint32_t Offset, uint32_t
     uint32_t i1;                                    // New index of first symbol
     uint32_t i2;                                    // New index of last symbol
     uint32_t i3;                                    // New index of first symbol after address
+    uint32_t n = AddressKeys.GetNumEntries();       // Number of symbols
 
-    // Make dummy symbol record for searching
-    SASymbol sym;
-    sym.Section = Section;
-    sym.Offset  = Offset;
+    // Make key for searching
+    uint64_t Key = SymbolAddressKey(Section, Offset);
 
-    // Search List by address
-    i1 = List.FindFirst(sym);
+    // Search AddressKeys by address
+    i1 = FindAddressKey(Key);
 
-    if (i1 == 0 || i1 >= List.GetNumEntries()) {
+    if (i1 == 0 || i1 >= n) {
         // No symbol found at this address or later. Return 0
         if (NextAfter) *NextAfter = 0;
         return 0;
     }
-    if (sym < List[i1]) {
+    uint64_t * k = &AddressKeys[0];                 // Keys have same index as symbols in List
+    if (Key < k[i1]) {
         // No symbol found at this address, but one found at higher address
         // Check if same section
-        if (List[i1].Section != Section) i1 = 0;
+        if ((k[i1] >> 32) != (Key >> 32)) i1 = 0;
         // Return symbol at later address
         if (NextAfter) *NextAfter = i1;
         return 0;
@@ -275,10 +315,10 @@ uint32_t CSymbolTable::FindByAddress(int32_t Section, uint32_t Offset, uint32_t
     // A symbol was found at this address.
     // Search for more symbols at same address
     i2 = i1;
-    while (i2+1 < List.GetNumEntries() && !(sym < List[i2+1])) i2++;
+    while (i2+1 < n && k[i2+1] == Key) i2++;
 
     // Search for first symbol after this address in same section
-    if (i2+1 < List.GetNumEntries() && List[i2+1].Section == Section) {
+    if (i2+1 < n && (k[i2+1] >> 32) == (Key >> 32)) {
         i3 = i2 + 1;                               // Found
     }
     else {
@@ -457,8 +497,17 @@ CDisassembler::CDisassembler() {
     InstructionSetMax = InstructionSetAMDMAX = 0;
     InstructionSetOR = FlagPrevious = NamesChanged = 0;
     WordSize = MasmOptions = RelocationsInSource = ExeType = 0;
+    RelocationCursor = 0;
     ImageBase = 0;
+    memset(PrefixCounts, 0, sizeof(PrefixCounts));
+    memset(ErrorCounts, 0, sizeof(ErrorCounts));
     Syntax = cmd.SubType;                         // Assembly syntax dialect
+    RecordFormat = 0;
+    if (Syntax == SUBTYPE_JSON || Syntax == SUBTYPE_BINREC || Syntax == SUBTYPE_STAT) {
+        // Structured output or statistics. Use MASM opcode names
+        RecordFormat = Syntax;
+        Syntax = SUBTYPE_MASM;
+    }
     if (Syntax == SUBTYPE_GASM) {
         CommentSeparator = "# ";                   // Symbol for indicating comment
         HereOperator = ".";                        // Symbol for current address
@@ -689,6 +738,17 @@ void CDisassembler::Go() {
     // Put names on unnamed symbols
     Symbols.AssignNames();
 
+    // Find functions to write, if -dfunc option
+    SelectFunctions();
+
+    if (RecordFormat) {
+        // Structured output. Write records instead of assembly text.
+        // Symbol names are written unchanged
+        Pass = 0x10;
+        WriteRecords();
+        return;
+    }
+
     // Fix invalid characters in symbol and section names
     CheckNamesValid();
 
@@ -732,6 +792,112 @@ void CDisassembler::Go() {
     WriteFileEnd();
 };
 
+void CDisassembler::SelectFunctions() {
+    // Find functions selected by -dfunc option.
+    // Pass 2 writes only the selected part of each selected function.
+    // A symbol with a known size selects only this symbol, not the whole
+    // function block, because function blocks can be big in executable 
+    // files without function boundary information
+    uint32_t nsel = cmd.DisasmSelect.GetNumEntries(); // Number of selection entries
+    uint32_t nfun = FunctionList.GetNumEntries();   // Number of functions
+    uint32_t i, ifun, symi;                         // Loop counters
+    uint32_t symlast, symnext;                      // Symbol search results
+    if (nsel == 0) return;                          // No selection. Everything is written
+
+    SelectedRange.SetNum(nfun + 1);
+    SectionSelected.SetNum(Sections.GetNumEntries());
+    SectionSelected.SetZero();
+
+    for (ifun = 1; ifun < nfun; ifun++) {
+        // Find end of function the same way as NextFunction2
+        int32_t  Sect = FunctionList[ifun].Section;
+        uint32_t Start = FunctionList[ifun].Start;
+        uint32_t End = FunctionList[ifun].End;
+        if ((uint32_t)Sect >= Sections.GetNumEntries()) continue;
+        if (End <= Start) {
+            // Size unknown. Continue until begin of next function or end of section
+            if (ifun + 1 < nfun && FunctionList[ifun+1].Section == Sect) End = FunctionList[ifun+1].Start;
+            else End = Sections[Sect].TotalSize;
+        }
+        if (End <= Start) continue;
+        uint32_t FunStart = Start + Sections[Sect].SectionAddress + (uint32_t)ImageBase; // Address as shown in listing
+
+        // First symbol in function
+        symlast = symnext = 0;
+        uint32_t symfirst = Symbols.FindByAddress(Sect, Start, &symlast, &symnext);
+        if (symfirst == 0) symfirst = symnext;
+
+        // Check each selection entry
+        for (i = 0; i < nsel; i++) {
+            SDisasmSelect & sel = cmd.DisasmSelect.Get<SDisasmSelect>(i * sizeof(SDisasmSelect));
+            uint32_t a = Start, b = End;            // Selected part of function
+            symi = 0;
+
+            if (sel.Type == 0) {
+                // Symbol name. Search for symbols in this function with matching name
+                if (symfirst == 0) continue;
+                for (symi = symfirst; symi < Symbols.GetNumEntries() && Symbols[symi].Section == Sect
+                && Symbols[symi].Offset < End; symi++) {
+                    if (strcmp(Symbols.GetName(symi), sel.Name) == 0) break;
+                }
+                if (symi >= Symbols.GetNumEntries() || Symbols[symi].Section != Sect
+                || Symbols[symi].Offset >= End) continue;
+            }
+            else {
+                // Address range. Only code sections are selected by address, 
+                // because sections in object files all start at address 0
+                if ((Sections[Sect].Type & 0xFF) != 1) continue;
+                // Check for overlap
+                if (sel.Start >= FunStart + (End - Start) || sel.End <= FunStart) continue;
+                if (sel.End - sel.Start > 1) {
+                    // Explicit range. Limit to this range
+                    if (sel.Start > FunStart) {
+                        // Start may be inside an instruction. Go back to the nearest
+                        // symbol or label, which is at an instruction boundary
+                        a = Start + (sel.Start - FunStart);
+                        uint32_t symstart = 0;
+                        for (symlast = symfirst; symlast && symlast < Symbols.GetNumEntries() 
+                        && Symbols[symlast].Section == Sect && Symbols[symlast].Offset <= a; symlast++) {
+                            symstart = symlast;
+                        }
+                        a = symstart ? Symbols[symstart].Offset : Start;
+                    }
+                    if (sel.End < FunStart + (End - Start)) b = Start + (sel.End - FunStart);
+                }
+                else if (symfirst) {
+                    // Single address. Find the last symbol before it
+                    uint32_t Offset = Start + (sel.Start - FunStart);
+                    for (symi = symfirst; symi + 1 < Symbols.GetNumEntries() 
+                    && Symbols[symi+1].Section == Sect && Symbols[symi+1].Offset <= Offset; symi++);
+                    if (Symbols[symi].Offset > Offset) symi = 0;
+                }
+            }
+            if (symi && Symbols[symi].Size && Symbols[symi].Offset + Symbols[symi].Size > a
+            && (sel.Type == 0 || Symbols[symi].Offset + Symbols[symi].Size > Start + (sel.Start - FunStart))) {
+                // Symbol has known size. Select only this symbol
+                if (Symbols[symi].Offset > a) a = Symbols[symi].Offset;
+                if (Symbols[symi].Offset + Symbols[symi].Size < b) b = Symbols[symi].Offset + Symbols[symi].Size;
+            }
+            // Merge with other selections in same function
+            SFunctionRecord & range = SelectedRange[ifun];
+            if (range.End == 0) {
+                range.Section = Sect;  range.Start = a;  range.End = b;
+            }
+            else {
+                if (a < range.Start) range.Start = a;
+                if (b > range.End)   range.End = b;
+            }
+            SectionSelected[Sect] = 1;
+            sel.Done++;
+        }
+    }
+    // Check if all names were found
+    for (i = 0; i < nsel; i++) {
+        SDisasmSelect & sel = cmd.DisasmSelect.Get<SDisasmSelect>(i * sizeof(SDisasmSelect));
+        if (sel.Done == 0) err.submit(1110, sel.Name);
+    }
+}
+
 void CDisassembler::Pass1() {
 
     /*             Pass 1: does the following jobs:
@@ -1285,6 +1451,11 @@ void CDisassembler::Pass2() {
         SectionType = Sections[Section].Type;
         if (SectionType & 0x800) continue;         // This is a group
 
+        if (SectionSelected.GetNumEntries() && !SectionSelected[Section]) {
+            // No function selected in this section by -dfunc option
+            continue;
+        }
+
         if (((SectionType & 0xFF) == 0x10) && cmd.DebugInfo == CMDL_DEBUG_STRIP) {
             // Skip debug section
             cmd.CountDebugRemoved();
@@ -1314,6 +1485,13 @@ void CDisassembler::Pass2() {
         // Loop through function blocks in this section
         while (NextFunction2()) {
 
+            if (SelectedRange.GetNumEntries()) {
+                // Write only the part selected by -dfunc option
+                if (SelectedRange[IFunction].End == 0) continue;
+                IEnd = SelectedRange[IFunction].Start;
+                FunctionEnd = SelectedRange[IFunction].End;
+            }
+
             // Check CodeMode from label
             NextLabel();
 
@@ -4128,16 +4306,43 @@ void CDisassembler::FindErrors() {
 }
 
 
+uint32_t CDisassembler::FindRelocation(int32_t Sect, uint32_t Offset) {
+    // Find first relocation with source address >= Sect:Offset.
+    // Returns the number of entries in Relocations if there is none.
+    // Pass 1 and pass 2 search for relocations at increasing addresses, so 
+    // the search begins where the previous search ended. A binary search is 
+    // used only if the address is not found within a few steps forward.
+    // Relocations may be inserted during pass 1. This does not invalidate
+    // the cursor because it is only used as a starting point.
+    SARelocation rel;                             // Make relocation record for searching
+    rel.Section = Sect;
+    rel.Offset  = Offset;
+    uint32_t n = Relocations.GetNumEntries();       // Number of relocations
+    SARelocation * r = &Relocations[0];           // Relocations is never empty. Entry 0 is a dummy
+    uint32_t i = RelocationCursor;                  // Start at previous result
+    uint32_t j;                                     // Step counter
+    if (i > n) i = n;
+    if (i == 0 || r[i-1] < rel) {
+        // The entry before i is below the search address. Search forwards from i
+        for (j = 0; j < 8 && i < n && r[i] < rel; j++) i++;
+        if (i == n || !(r[i] < rel)) {
+            // Found within a few steps
+            return RelocationCursor = i;
+        }
+    }
+    // Not near the previous position. Do a binary search
+    return RelocationCursor = Relocations.FindFirst(rel);
+}
+
+
 void CDisassembler::FindRelocations() {
     // Find any relocation sources in this instruction
-    SARelocation rel1, rel2;                      // Make relocation records for searching
-    rel1.Section = Section;
-    rel1.Offset  = IBegin;                        // rel1 marks begin of this instruction
+    SARelocation rel2;                            // Make relocation record for comparing
     rel2.Section = Section;
     rel2.Offset  = IEnd;                          // rel2 marks end of this instruction
 
     // Search for relocations in this instruction
-    uint32_t irel = Relocations.FindFirst(rel1);    // Finds first relocation source >= IBegin
+    uint32_t irel = FindRelocation(Section, IBegin); // Finds first relocation source >= IBegin
 
     if (irel == 0 || irel >= Relocations.GetNumEntries()) {
         // No relocations found
@@ -4200,8 +4405,8 @@ void CDisassembler::FindRelocations() {
 }
 
 
-void CDisassembler::FindInstructionSet() {
-    // Update instruction set
+uint16_t CDisassembler::GetInstructionSet() {
+    // Get instruction set of current instruction
     uint16_t InstSet = s.OpcodeDef->InstructionSet;
     if (InstSet == 7 && s.Prefixes[5] == 0x66) {
         // Change MMX to SSE2 if 66 prefix
@@ -4222,6 +4427,13 @@ void CDisassembler::FindInstructionSet() {
             if (InstSet < 0x80) InstSet = 0x80;
         }
     }
+    return InstSet;
+}
+
+void CDisassembler::FindInstructionSet() {
+    // Update instruction set
+    uint16_t InstSet = GetInstructionSet();
+
     if ((InstSet & 0xFF00) == 0x1000) {
         // AMD-specific instruction set
         // Set AMD-specific instruction set to max
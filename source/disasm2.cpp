@@ -1372,8 +1372,6 @@ void CDisassembler::WriteDataItems() {
     const char * Symname;                         // Symbol name
     int    SeparateLine;                          // Label is on separate line
 
-    SARelocation Rel;                             // Dummy relocation record
-
     // Check if size is valid
     if (DataSize == 0) DataSize = 1;
     if (DataSize > 32) DataSize = 32;  
@@ -1531,9 +1529,7 @@ void CDisassembler::WriteDataItems() {
             Oldirel = irel;
 
             // Check if relocation
-            Rel.Section = Section;
-            Rel.Offset  = Pos;
-            uint32_t irel = Relocations.FindFirst(Rel);
+            uint32_t irel = FindRelocation(Section, Pos);
             if (irel >= Relocations.GetNumEntries() || Relocations[irel].Section != (int32_t)Section) {
                 // No relevant relocation
                 irel = 0;
@@ -3672,90 +3668,21 @@ void CDisassembler::WriteAssume() {
 }
 
 
-void CDisassembler::WriteInstruction() {
-    // Write instruction and operands
-    uint32_t NumOperands = 0;                       // Number of operands written
+void CDisassembler::WriteOpcodeName(CTextFileBuffer & Out) {
+    // Write opcode name with 'v' prefix and operand size or type suffix, if any
     uint32_t i;                                     // Loop index
-    const char * OpName;                          // Opcode name
-
-    if (s.AddressFieldSize && Syntax == SUBTYPE_MASM) {
-        // There is a memory operand. Check if ASSUME directive needed
-        WriteAssume();
-    }
-
-    if (CodeMode & 6) {
-        // Code is dubious. Show as comment only
-        OutFile.Put(CommentSeparator);             // Start comment
-    }
-    else if ((s.OpcodeDef->Options & 0x20) && s.OpcodeStart1 > IBegin) {
-        // Write prefixes explicitly. 
-        // This is used for rare cases where the assembler cannot generate the prefix
-        OutFile.Tabulate(AsmTab1);                 // Tabulate
-        OutFile.Put(Syntax == SUBTYPE_GASM ? ".byte " : "DB ");
-        OutFile.Tabulate(AsmTab2);                 // Tabulate
-        for (i = IBegin; i < s.OpcodeStart1; i++) {
-            if (i > IBegin) OutFile.Put(", ");
-            OutFile.PutHex(Get<uint8_t>(i), 1);
-        }
-        OutFile.Tabulate(AsmTab3);                 // Tabulate
-        OutFile.Put(CommentSeparator);
-        if ((s.OpcodeDef->AllowedPrefixes & 8) && Get<uint8_t>(IBegin) == 0xF2) {
-            OutFile.Put("BND prefix coded explicitly");    // Comment
-        }
-        else {        
-            OutFile.Put("Prefix coded explicitly");    // Comment
-        }
-        OutFile.NewLine();
-    }
-
-    if ((s.Operands[0] & 0xF0) == 0xC0 || (s.Operands[1] & 0xF0) == 0xC0) {
-        // String instruction or xlat instruction
-        WriteStringInstruction();
-        return;
-    }
-
-    OutFile.Tabulate(AsmTab1);                     // Tabulate
-
-    if ((s.OpcodeDef->AllowedPrefixes & 0xC40) == 0xC40) {
-        switch (s.Prefixes[5]) {
-        case 0xF2:
-            OutFile.Put("xacquire ");  break;      // xacquire prefix
-        case 0xF3:
-            OutFile.Put("xrelease ");  break;      // xrelease prefix
-        }
-    }
-    if (s.Prefixes[2]) {
-        OutFile.Put("lock ");                      // Lock prefix
-    }
-
-    // Get opcode name
-    if (s.OpcodeDef->Name) {
-        // Opcode name
-        OpName = s.OpcodeDef->Name;
-        // Search for opcode comment
-        s.OpComment = strchr(OpName, ';');
-        if (s.OpComment) s.OpComment++;            // Point to after ';'
-    }
-    else {
-        OpName = "UNDEFINED";                      // Undefined code with no name
-        s.OpComment = 0;
-    }
+    const char * OpName = s.OpcodeDef->Name;      // Opcode name
+    if (OpName == 0) OpName = "UNDEFINED";        // Undefined code with no name
 
     // Check prefix option
     if ((s.OpcodeDef->Options & 2) && (s.Prefixes[7] & 0x30)) {
         // Put prefix 'v' for VEX-prefixed instruction
-        OutFile.Put('v');
+        Out.Put('v');
     }
 
-    // Write opcode name
-    if (s.OpComment) {
-        // OpName string contains opcode name and comment, separated by ';'
-        while (*OpName != ';' && *OpName != 0) {   // Write opcode name until comment
-            OutFile.Put(*(OpName++));
-        }
-    }
-    else {
-        OutFile.Put(OpName);                       // Write normal opcode name
+    // Write opcode name until comment, if any
+    while (*OpName != ';' && *OpName != 0) {
+        Out.Put(*(OpName++));
     }
 
     // Check suffix option
@@ -3764,7 +3691,7 @@ void CDisassembler::WriteInstruction() {
         if ((s.OpcodeDef->AllowedPrefixes & 0x7000) == 0x1000) {
             // F.P. operand size defined by W prefix bit
             i = s.Prefixes[7] & 8;  // W prefix bit
-            OutFile.Put(i ? 'd' : 's');
+            Out.Put(i ? 'd' : 's');
         }
         else if ((s.OpcodeDef->AllowedPrefixes & 0x7000) == 0x3000) {
             // Integer or f.p. operand size defined by W prefix bit
@@ -3777,34 +3704,34 @@ void CDisassembler::WriteInstruction() {
             }
             i = s.Prefixes[7] & 8;  // W prefix bit
             if (f) {
-                OutFile.Put(i ? 'd' : 's');  // float precision suffix
+                Out.Put(i ? 'd' : 's');  // float precision suffix
             }
             else {            
-                OutFile.Put(i ? 'q' : 'd');  // integer size suffix
+                Out.Put(i ? 'q' : 'd');  // integer size suffix
             }
         }
         else if ((s.OpcodeDef->AllowedPrefixes & 0x7000) == 0x4000) {
             // Integer operand size defined by W prefix bit
             i = s.Prefixes[7] & 8;  // W prefix bit
-            OutFile.Put(i ? 'w' : 'b');
+            Out.Put(i ? 'w' : 'b');
         }
         else if ((s.OpcodeDef->AllowedPrefixes & 0x7000) == 0x5000) {
             // mask register operand size defined by W prefix bit and 66 prefix
             i  = (s.Prefixes[7] & 8) >> 2;      // W prefix bit
             i |= s.Prefixes[5] != 0x66;         // 66 prefix bit
-            OutFile.Put("bwdq"[i]);
+            Out.Put("bwdq"[i]);
         }
         else if (s.OpcodeDef->AllowedPrefixes & 0xE00) {
             // F.P. operand type and size defined by prefixes
             switch (s.Prefixes[5]) {
             case 0:     // No prefix = ps
-                OutFile.Put("ps");  break;
+                Out.Put("ps");  break;
             case 0x66:  // 66 prefix = pd
-                OutFile.Put("pd");  break;
+                Out.Put("pd");  break;
             case 0xF3:  // F3 prefix = ss
-                OutFile.Put("ss");  break;
+                Out.Put("ss");  break;
             case 0xF2:  // F2 prefix = sd
-                OutFile.Put("sd");  break;
+                Out.Put("sd");  break;
             default:
                 err.submit(9000); // Should not occur
             }
@@ -3815,7 +3742,7 @@ void CDisassembler::WriteInstruction() {
             i = s.OperandSize / 8;
             if (i <= 8) {
                 static const char SizeSuffixes[] = " bw d f q"; // Table of suffixes
-                OutFile.Put(SizeSuffixes[i]);
+                Out.Put(SizeSuffixes[i]);
             }
         }
     }
@@ -3825,18 +3752,81 @@ void CDisassembler::WriteInstruction() {
         if ((s.OpcodeDef->AllowedPrefixes & 0x7000) == 0x3000) {
             // Integer operand size defined by W prefix bit
             i = ((s.Prefixes[7] & 8) + 8) * 4;  // W prefix bit -> 8 / 16
-            OutFile.PutDecimal(i);
+            Out.PutDecimal(i);
         }
         if ((s.OpcodeDef->AllowedPrefixes & 0x7000) == 0x4000) { // 32 / 64
             i = (s.Prefixes[7] & 8) + 8;  // W prefix bit -> 8 / 16
-            OutFile.PutDecimal(i);
+            Out.PutDecimal(i);
         }
     }
     // More suffix option
     if ((s.OpcodeDef->Options & 0x400) && s.ImmediateFieldSize == 8) {
         // 64 bit immediate mov
-        if (Syntax == SUBTYPE_GASM) OutFile.Put("abs");
+        if (Syntax == SUBTYPE_GASM) Out.Put("abs");
     }   
+}
+
+void CDisassembler::WriteInstruction() {
+    // Write instruction and operands
+    uint32_t NumOperands = 0;                       // Number of operands written
+    uint32_t i;                                     // Loop index
+
+    if (s.AddressFieldSize && Syntax == SUBTYPE_MASM) {
+        // There is a memory operand. Check if ASSUME directive needed
+        WriteAssume();
+    }
+
+    if (CodeMode & 6) {
+        // Code is dubious. Show as comment only
+        OutFile.Put(CommentSeparator);             // Start comment
+    }
+    else if ((s.OpcodeDef->Options & 0x20) && s.OpcodeStart1 > IBegin) {
+        // Write prefixes explicitly. 
+        // This is used for rare cases where the assembler cannot generate the prefix
+        OutFile.Tabulate(AsmTab1);                 // Tabulate
+        OutFile.Put(Syntax == SUBTYPE_GASM ? ".byte " : "DB ");
+        OutFile.Tabulate(AsmTab2);                 // Tabulate
+        for (i = IBegin; i < s.OpcodeStart1; i++) {
+            if (i > IBegin) OutFile.Put(", ");
+            OutFile.PutHex(Get<uint8_t>(i), 1);
+        }
+        OutFile.Tabulate(AsmTab3);                 // Tabulate
+        OutFile.Put(CommentSeparator);
+        if ((s.OpcodeDef->AllowedPrefixes & 8) && Get<uint8_t>(IBegin) == 0xF2) {
+            OutFile.Put("BND prefix coded explicitly");    // Comment
+        }
+        else {        
+            OutFile.Put("Prefix coded explicitly");    // Comment
+        }
+        OutFile.NewLine();
+    }
+
+    if ((s.Operands[0] & 0xF0) == 0xC0 || (s.Operands[1] & 0xF0) == 0xC0) {
+        // String instruction or xlat instruction
+        WriteStringInstruction();
+        return;
+    }
+
+    OutFile.Tabulate(AsmTab1);                     // Tabulate
+
+    if ((s.OpcodeDef->AllowedPrefixes & 0xC40) == 0xC40) {
+        switch (s.Prefixes[5]) {
+        case 0xF2:
+            OutFile.Put("xacquire ");  break;      // xacquire prefix
+        case 0xF3:
+            OutFile.Put("xrelease ");  break;      // xrelease prefix
+        }
+    }
+    if (s.Prefixes[2]) {
+        OutFile.Put("lock ");                      // Lock prefix
+    }
+
+    // Search for opcode comment
+    s.OpComment = s.OpcodeDef->Name ? strchr(s.OpcodeDef->Name, ';') : 0;
+    if (s.OpComment) s.OpComment++;                // Point to after ';'
+
+    // Write opcode name with prefix and suffixes
+    WriteOpcodeName(OutFile);
 
     // Space between opcode name and operands
     OutFile.Put(" "); OutFile.Tabulate(AsmTab2);  // Tabulate. At least one space
@@ -4082,6 +4072,14 @@ void CDisassembler::WriteCodeComment() {
     // Start of instruction
     i = IBegin;
 
+    // Find first relocation source in instruction, if any
+    uint32_t NumRel = Relocations.GetNumEntries();  // Number of relocations
+    uint32_t irel = FindRelocation(Section, IBegin);// First relocation source >= IBegin
+    if (irel >= NumRel || Relocations[irel].Section != (int32_t)Section || Relocations[irel].Offset >= IEnd) {
+        // No relocation in this instruction
+        irel = 0;
+    }
+
     // Write bytes
     while (i < IEnd) {
         FieldSize = 1;                             // Size of field to write
@@ -4139,15 +4137,14 @@ void CDisassembler::WriteCodeComment() {
             OutFile.PutHex(Get<uint64_t>(i));
             break;
         }
-        // Search for relocation
-        SARelocation rel1;                            // Make relocation records for searching
-        rel1.Section = Section;
-        rel1.Offset  = i;                             // rel1 marks current field in instruction
+        // Skip relocations before current field.
+        // The fields are written in ascending order, so the relocations are found in the same order
+        while (irel && Relocations[irel].Offset < i) {
+            if (++irel >= NumRel || Relocations[irel].Section != (int32_t)Section) irel = 0;
+        }
 
         // Is there a relocation source exactly here?
-        int32_t irel = Relocations.Exists(rel1);        // Finds relocation with source = i
-
-        if (irel > 0) {
+        if (irel && Relocations[irel].Offset == i) {
             // This field has a relocation. Indicate relocation type
             // 0 = unknown, 1 = direct, 2 = self-relative, 3 = image-relative, 
             // 4 = segment relative, 5 = relative to arbitrary ref. point, 8 = segment address/descriptor
@@ -4169,6 +4166,639 @@ void CDisassembler::WriteCodeComment() {
 }
 
 
+/**********************  Structured output   *********************************
+The options -fjson and -fbin make the disassembler write one record for each
+instruction in the code sections instead of assembly text. This is intended
+for analysis tools that would otherwise have to parse the assembly text.
+
+-fjson writes JSON Lines: One JSON object per line. The "type" field tells
+which kind of record it is:
+  "file":        imagebase
+  "section":     index, name, address, size, wordsize. Precedes the 
+                 instructions in this section
+  "function":    index, name, section, start, end. Precedes the 
+                 instructions in this function
+  "instruction": section, offset, address, length, bytes, opcode, mnemonic,
+                 operands, function, flags, and optionally target and addend
+                 for a relocation or jump for a direct jump/call address
+Addresses are image-relative. The meaning of opcode, operands and flags is 
+the same as in SAInstructionRecord.
+
+-fbin writes the same information as packed binary records. The file layout 
+is described at SARecordFileHeader in disasm.h.
+
+-fstat writes no instructions, only a summary of how many instructions there
+are of each mnemonic, instruction set and prefix type, how many have each
+kind of warning or error, and the number of instructions per function.
+Functions that mix legacy SSE code and VEX or EVEX code are marked, because
+transitions between these are costly on some processors.
+*****************************************************************************/
+
+void CDisassembler::WriteRecords() {
+    // Pass 2 for structured output: Write a record for each instruction 
+    // instead of assembly text. Data sections and data in code sections are 
+    // skipped
+    OutFile.SetFileType(FILETYPE_ASM);
+
+    RecordStrings.Push(0, 1);                      // Make string 0 empty
+
+    if (RecordFormat == SUBTYPE_BINREC) {
+        // Make space for file header. It is filled in by WriteRecordTables
+        OutFile.Push(0, sizeof(SARecordFileHeader));
+    }
+    else if (RecordFormat == SUBTYPE_STAT) {
+        // Make counters
+        FunctionStats.SetNum(FunctionList.GetNumEntries());
+        InstructionSetCounts.SetNum(0x4000);
+    }
+    else {
+        // Write file record
+        OutFile.Put("{\"type\":\"file\",\"imagebase\":\"0x");
+        OutFile.PutHex((uint64_t)ImageBase);
+        OutFile.Put("\"}");
+        OutFile.NewLine();
+    }
+
+    // Loop through sections
+    for (Section = 1; Section < Sections.GetNumEntries(); Section++) {
+
+        // Get section type. Only code sections are written
+        SectionType = Sections[Section].Type;
+        if ((SectionType & 0xFF) != 1) continue;
+        if (SectionSelected.GetNumEntries() && !SectionSelected[Section]) continue;
+
+        // Initialize
+        CodeMode = 1;
+        LabelBegin = FlagPrevious = CountErrors = 0;
+        Buffer = Sections[Section].Start;
+        SectionEnd = Sections[Section].TotalSize;
+        LabelInaccessible = Sections[Section].InitSize;
+        WordSize = Sections[Section].WordSize;
+        SectionAddress = Sections[Section].SectionAddress;
+        if (Buffer == 0) continue;
+
+        if (RecordFormat == SUBTYPE_JSON) WriteSectionRecordJSON();
+
+        IBegin = IEnd = LabelEnd = IFunction = DataType = DataSize = 0;
+
+        // Loop through function blocks in this section
+        while (NextFunction2()) {
+
+            if (SelectedRange.GetNumEntries()) {
+                // Write only the part selected by -dfunc option
+                if (SelectedRange[IFunction].End == 0) continue;
+                IEnd = SelectedRange[IFunction].Start;
+                FunctionEnd = SelectedRange[IFunction].End;
+            }
+
+            // Check CodeMode from label
+            NextLabel();
+
+            // Write function record
+            if ((CodeMode & 3) && RecordFormat == SUBTYPE_JSON) WriteFunctionRecordJSON();
+
+            // Loop through labels
+            while (NextLabel()) {
+
+                // Loop through code
+                while (NextInstruction2()) {
+
+                    if (CodeMode & 3) {
+                        // Interpret this as code
+                        ParseInstruction();
+                        if (RecordFormat == SUBTYPE_STAT) CountInstruction();
+                        else WriteInstructionRecord();
+                    }
+                    else {
+                        // Data. Skip to next label
+                        IEnd = LabelEnd;
+                    }
+                    if (IEnd <= IBegin) {
+                        // Prevent infinite loop
+                        IEnd++;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    if (RecordFormat == SUBTYPE_BINREC) {
+        // Write tables after instruction records
+        WriteRecordTables();
+    }
+    if (RecordFormat == SUBTYPE_STAT) {
+        // Write statistics
+        WriteStatistics();
+    }
+}
+
+void CDisassembler::WriteInstructionRecord() {
+    // Write record for one instruction
+    SAInstructionRecord rec;                      // Instruction record
+    uint32_t i;                                     // Loop counter
+    int32_t  Value;                                 // Jump displacement
+
+    memset(&rec, 0, sizeof(rec));
+    rec.Section  = Section;
+    rec.Offset   = IBegin;
+    rec.Function = IFunction;
+    rec.OpcodeId = Opcodei;
+    rec.Length   = (uint8_t)(IEnd - IBegin > 0xFF ? 0xFF : IEnd - IBegin);
+    for (i = 0; i < 5; i++) rec.Operands[i] = s.Operands[i];
+    for (i = 0; i < 16 && IBegin + i < IEnd; i++) rec.Bytes[i] = Buffer[IBegin + i];
+
+    // Flags
+    if (CodeMode & 2) rec.Flags |= 1;              // Dubious. May be data
+    if (s.Warnings1 | s.Warnings2) rec.Flags |= 2; // Has warnings
+    if (s.Errors) rec.Flags |= 4;                  // Has errors
+
+    // Find relocation target or jump target
+    uint32_t irel = s.AddressRelocation ? s.AddressRelocation : s.ImmediateRelocation;
+    if (irel && irel < Relocations.GetNumEntries() && Relocations[irel].TargetOldIndex) {
+        // Relocation target
+        rec.Flags |= 8;
+        rec.Target = Relocations[irel].TargetOldIndex;
+        rec.Addend = Relocations[irel].Addend;
+    }
+    else if (s.ImmediateFieldSize && !s.ImmediateRelocation) {
+        // Look for direct near jump or call without relocation
+        for (i = 0; i < 5; i++) {
+            if ((s.Operands[i] & 0xFC) == 0x80) break;
+        }
+        if (i < 5) {
+            switch (s.ImmediateFieldSize) {
+            case 1:  Value = Get<int8_t>(s.ImmediateField);  break;
+            case 2:  Value = Get<int16_t>(s.ImmediateField); break;
+            case 4:  Value = Get<int32_t>(s.ImmediateField); break;
+            default: Value = 0;  i = 5;
+            }
+            if (i < 5) {
+                rec.Flags |= 0x10;
+                rec.Target = IEnd + Value + SectionAddress;
+                if (WordSize == 16) rec.Target = (uint16_t)(IEnd + Value) + SectionAddress;
+            }
+        }
+    }
+
+    if (RecordFormat == SUBTYPE_BINREC) {
+        // Binary record. Find mnemonic in string table
+        rec.Mnemonic = Mnemonics[FindMnemonic()].Name;
+        OutFile.Push(&rec, sizeof(rec));
+        return;
+    }
+
+    // JSON record
+    OutFile.Put("{\"type\":\"instruction\",\"section\":");
+    OutFile.PutDecimal(rec.Section);
+    OutFile.Put(",\"offset\":");
+    OutFile.PutDecimal(rec.Offset);
+    OutFile.Put(",\"address\":");
+    OutFile.PutDecimal(rec.Offset + SectionAddress);
+    OutFile.Put(",\"length\":");
+    OutFile.PutDecimal(IEnd - IBegin);
+    OutFile.Put(",\"bytes\":\"");
+    for (i = IBegin; i < IEnd; i++) OutFile.PutHex(Buffer[i]);
+    OutFile.Put("\",\"opcode\":");
+    OutFile.PutDecimal(rec.OpcodeId);
+    OutFile.Put(",\"mnemonic\":");
+    WriteJSONString((char*)RecordStrings.Buf() + Mnemonics[FindMnemonic()].Name);
+    OutFile.Put(",\"operands\":[");
+    for (i = 0; i < 5 && rec.Operands[i]; i++) {
+        if (i) OutFile.Put(',');
+        OutFile.PutDecimal(rec.Operands[i]);
+    }
+    OutFile.Put("],\"function\":");
+    OutFile.PutDecimal(rec.Function);
+    OutFile.Put(",\"flags\":");
+    OutFile.PutDecimal(rec.Flags);
+    if (rec.Flags & 8) {
+        OutFile.Put(",\"target\":");
+        WriteJSONString(Symbols.GetNameO(rec.Target));
+        OutFile.Put(",\"addend\":");
+        OutFile.PutDecimal(rec.Addend, 1);
+    }
+    if (rec.Flags & 0x10) {
+        OutFile.Put(",\"jump\":");
+        OutFile.PutDecimal(rec.Target);
+    }
+    OutFile.Put('}');
+    OutFile.NewLine();
+}
+
+uint32_t CDisassembler::FindMnemonic() {
+    // Find current mnemonic in Mnemonics. Add it if not found.
+    // The name is determined by the opcode map entry, the VEX prefix and the
+    // prefixes and operands that determine the suffix.
+    // Returns index into Mnemonics
+    SAMnemonic mn;                                // Mnemonic record
+    uint32_t i;                                     // Loop counter
+    memset(&mn, 0, sizeof(mn));
+    mn.OpcodeDef = s.OpcodeDef;
+    if ((s.OpcodeDef->Options & 2) && (s.Prefixes[7] & 0x30)) mn.VEX = 1;
+    if (s.OpcodeDef->Options & 0x1001) {
+        // Name has suffix. Get everything the suffix depends on
+        mn.Suffix = (s.Prefixes[7] & 8) | s.Prefixes[5] << 8 | s.OperandSize << 16;
+        for (i = 0; i < s.MaxNumOperands; i++) {
+            if ((s.Operands[i] & 0xF0) == 0x40) mn.Suffix |= 1;  // Floating point operand
+        }
+    }
+    int32_t m = Mnemonics.Exists(mn);
+    if (m < 0) {
+        // New mnemonic. Make name
+        CTextFileBuffer Name;
+        WriteOpcodeName(Name);
+        Name.Put((char)0);
+        // Several opcode map entries can have the same name. Store each name only once
+        for (i = 0; i < Mnemonics.GetNumEntries(); i++) {
+            if (strcmp((char*)RecordStrings.Buf() + Mnemonics[i].Name, (char*)Name.Buf()) == 0) {
+                mn.Name = Mnemonics[i].Name;  break;
+            }
+        }
+        if (mn.Name == 0) mn.Name = RecordString((char*)Name.Buf());
+        m = Mnemonics.PushSort(mn);
+    }
+    return m;
+}
+
+void CDisassembler::CountInstruction() {
+    // Update statistics for current instruction (-fstat)
+    uint32_t Length = IEnd - IBegin;              // Instruction length
+    uint32_t InstSet = 0;                         // Instruction set
+    uint32_t n;                                   // Bit number
+    uint8_t  p6 = s.Prefixes[6], p7 = s.Prefixes[7]; // VEX and REX prefix categories
+    int      Vex = 0;                             // 1 = VEX or XOP, 2 = EVEX or MVEX
+
+    // Count mnemonic
+    SAMnemonic & mn = Mnemonics[FindMnemonic()];
+    mn.Count++;  mn.Bytes += Length;
+
+    // Count instruction set
+    if (s.OpcodeDef) {
+        InstSet = GetInstructionSet() & 0x3FFF;
+        InstructionSetCounts[InstSet]++;
+    }
+
+    // Count prefixes. See PrefixCountNames for the meaning of each index
+    if (p6 & 0x40) {
+        PrefixCounts[(p6 & 0x20) ? 4 : 5]++;      // EVEX or MVEX
+        Vex = 2;
+    }
+    else if (p7 & 0x80) {
+        PrefixCounts[3]++;  Vex = 1;              // XOP
+    }
+    else if (p7 & 0x20) {
+        PrefixCounts[2]++;  Vex = 1;              // 3-bytes VEX
+    }
+    else if (p7 & 0x10) {
+        PrefixCounts[1]++;  Vex = 1;              // 2-bytes VEX
+    }
+    else {
+        if (p7 & 0x40) PrefixCounts[0]++;         // REX
+        if (s.Prefixes[4] == 0x66) PrefixCounts[6]++; // Operand size
+        // F2 and F3 count as repeat prefixes only where REP/REPE/REPNE is allowed,
+        // not where they are part of the opcode (e.g. scalar SSE instructions)
+        if (s.OpcodeDef && (s.OpcodeDef->AllowedPrefixes & 0x60)
+        && ((s.Prefixes[3] == 0xF2 && !(s.OpcodeDef->AllowedPrefixes & 0x800))
+        ||  (s.Prefixes[3] == 0xF3 && !(s.OpcodeDef->AllowedPrefixes & 0x400)))) {
+            PrefixCounts[10]++;                   // Repeat
+        }
+    }
+    if (s.Prefixes[1]) PrefixCounts[7]++;         // Address size
+    if (s.Prefixes[0]) PrefixCounts[8]++;         // Segment
+    if (s.Prefixes[2]) PrefixCounts[9]++;         // Lock
+
+    // Count warnings and errors
+    if (s.Errors | s.Warnings1 | s.Warnings2) {
+        for (n = 0; n < 32; n++) {
+            ErrorCounts[0][n] += (s.Errors >> n) & 1;
+            ErrorCounts[1][n] += (s.Warnings1 >> n) & 1;
+            ErrorCounts[2][n] += (s.Warnings2 >> n) & 1;
+        }
+    }
+
+    // Count per function
+    if (IFunction < FunctionStats.GetNumEntries()) {
+        SAFunctionStat & fs = FunctionStats[IFunction];
+        fs.Instructions++;  fs.Bytes += Length;
+        if (Vex == 1) fs.VEX++;
+        else if (Vex == 2) fs.EVEX++;
+        else if ((InstSet & 0xFF00) == 0 && InstSet >= 0x11 && InstSet <= 0x18) fs.LegacySSE++;
+    }
+}
+
+// Names of prefix types counted in CountInstruction
+static const char * PrefixCountNames[] = {
+    "REX", "VEX, 2 bytes", "VEX, 3 bytes", "XOP", "EVEX", "MVEX",
+    "Operand size (66)", "Address size (67)", "Segment", "Lock", "Repeat (F2, F3)"
+};
+
+// Names of instruction sets other than InstructionSetNames
+static SIntTxt InstructionSetNames2[] = {
+    {0x100,  "8087"},
+    {0x101,  "80387"},
+    {0x800,  "Privileged"},
+    {0x1001, "AMD 3DNow"},
+    {0x1002, "AMD 3DNowE"},
+    {0x1004, "AMD SSE4a"},
+    {0x1005, "AMD XOP"},
+    {0x1006, "AMD FMA4"},
+    {0x1007, "AMD TBM"},
+    {0x2001, "VIA"}
+};
+
+// Structure for sorting mnemonics by count
+struct SMnemonicCount {
+    uint32_t Name;                                // Mnemonic, as offset into RecordStrings
+    uint32_t Count;                               // Number of instructions
+    uint32_t Bytes;                               // Total size of instructions
+    int operator < (const SMnemonicCount & y) const { // Sort by descending count
+        return Count > y.Count || (Count == y.Count && Name < y.Name);}
+};
+
+void CDisassembler::PutDecimalRight(uint32_t x, uint32_t column) {
+    // Write decimal number right-aligned so that it ends at column
+    char text[16];
+    sprintf(text, "%u", x);
+    OutFile.Tabulate(column - (uint32_t)strlen(text));
+    OutFile.Put(text);
+}
+
+void CDisassembler::WriteStatistics() {
+    // Write instruction statistics (-fstat)
+    CSList<SMnemonicCount> Counts;                // Mnemonics merged by name
+    SMnemonicCount mc;                            // Entry in Counts
+    uint32_t i, j, n;                             // Loop counters
+    uint32_t Total = 0, TotalBytes = 0;           // Total number and size of instructions
+    uint32_t symi;                                // Symbol index
+
+    // Merge mnemonics with same name
+    for (i = 0; i < Mnemonics.GetNumEntries(); i++) {
+        if (Mnemonics[i].Count == 0) continue;
+        for (j = 0; j < Counts.GetNumEntries(); j++) {
+            if (Counts[j].Name == Mnemonics[i].Name) break;
+        }
+        if (j == Counts.GetNumEntries()) {
+            mc.Name = Mnemonics[i].Name;  mc.Count = mc.Bytes = 0;
+            Counts.Push(mc);
+        }
+        Counts[j].Count += Mnemonics[i].Count;
+        Counts[j].Bytes += Mnemonics[i].Bytes;
+        Total += Mnemonics[i].Count;
+        TotalBytes += Mnemonics[i].Bytes;
+    }
+    Counts.Sort();
+
+    OutFile.Put("Instructions: ");  OutFile.PutDecimal(Total);
+    OutFile.Put(", bytes: ");  OutFile.PutDecimal(TotalBytes);
+    OutFile.NewLine();
+
+    // Mnemonics
+    OutFile.NewLine();
+    OutFile.Put("Mnemonics:");  OutFile.NewLine();
+    OutFile.Put("    count");  OutFile.Tabulate(12);  OutFile.Put("bytes");
+    OutFile.Tabulate(24);  OutFile.Put("mnemonic");  OutFile.NewLine();
+    for (i = 0; i < Counts.GetNumEntries(); i++) {
+        PutDecimalRight(Counts[i].Count, 9);
+        PutDecimalRight(Counts[i].Bytes, 17);
+        OutFile.Tabulate(24);
+        OutFile.Put((char*)RecordStrings.Buf() + Counts[i].Name);
+        OutFile.NewLine();
+    }
+
+    // Instruction sets
+    OutFile.NewLine();
+    OutFile.Put("Instruction sets:");  OutFile.NewLine();
+    for (i = 0; i < InstructionSetCounts.GetNumEntries(); i++) {
+        if (InstructionSetCounts[i] == 0) continue;
+        PutDecimalRight(InstructionSetCounts[i], 9);
+        OutFile.Tabulate(12);
+        OutFile.PutHex((uint16_t)i);
+        OutFile.Tabulate(24);
+        if (i < (uint32_t)InstructionSetNamesLen && *InstructionSetNames[i]) OutFile.Put(InstructionSetNames[i]);
+        else OutFile.Put(Lookup(InstructionSetNames2, i));
+        OutFile.NewLine();
+    }
+
+    // Prefixes
+    OutFile.NewLine();
+    OutFile.Put("Prefixes:");  OutFile.NewLine();
+    for (i = 0; i < TableSize(PrefixCountNames); i++) {
+        if (PrefixCounts[i] == 0) continue;
+        PutDecimalRight(PrefixCounts[i], 9);
+        OutFile.Tabulate(24);
+        OutFile.Put(PrefixCountNames[i]);
+        OutFile.NewLine();
+    }
+
+    // Errors and warnings
+    OutFile.NewLine();
+    OutFile.Put("Errors and warnings:");  OutFile.NewLine();
+    for (j = 0; j < 3; j++) {
+        for (n = 0; n < 32; n++) {
+            if (ErrorCounts[j][n] == 0) continue;
+            PutDecimalRight(ErrorCounts[j][n], 9);
+            OutFile.Tabulate(12);
+            switch (j) {
+            case 0:
+                OutFile.Put("Error: ");  OutFile.Put(Lookup(AsmErrorTexts, 1u << n));  break;
+            case 1:
+                OutFile.Put("Note: ");  OutFile.Put(Lookup(AsmWarningTexts1, 1u << n));  break;
+            case 2:
+                OutFile.Put("Warning: ");  OutFile.Put(Lookup(AsmWarningTexts2, 1u << n));  break;
+            }
+            OutFile.NewLine();
+        }
+    }
+
+    // Functions
+    OutFile.NewLine();
+    OutFile.Put("Functions:");  OutFile.NewLine();
+    OutFile.Put("address");  OutFile.Tabulate(12);  OutFile.Put("instr");  
+    OutFile.Tabulate(20);  OutFile.Put("bytes");  OutFile.Tabulate(28);  OutFile.Put("sse");
+    OutFile.Tabulate(36);  OutFile.Put("vex");  OutFile.Tabulate(44);  OutFile.Put("evex");
+    OutFile.Tabulate(52);  OutFile.Put("name");  OutFile.NewLine();
+    for (i = 1; i < FunctionStats.GetNumEntries(); i++) {
+        SAFunctionStat & fs = FunctionStats[i];
+        if (fs.Instructions == 0) continue;
+        Section = FunctionList[i].Section;
+        OutFile.PutHex(FunctionList[i].Start + Sections[Section].SectionAddress + (uint32_t)ImageBase);
+        PutDecimalRight(fs.Instructions, 17);
+        PutDecimalRight(fs.Bytes, 25);
+        PutDecimalRight(fs.LegacySSE, 33);
+        PutDecimalRight(fs.VEX, 41);
+        PutDecimalRight(fs.EVEX, 49);
+        OutFile.Tabulate(52);
+        symi = FunctionList[i].OldSymbolIndex ? Symbols.Old2NewIndex(FunctionList[i].OldSymbolIndex) : 0;
+        if (symi == 0) symi = Symbols.FindByAddress(Section, FunctionList[i].Start);
+        if (symi) OutFile.Put(Symbols.GetName(symi));
+        if (fs.LegacySSE && (fs.VEX | fs.EVEX)) {
+            // Transitions between legacy SSE and VEX code may be costly
+            OutFile.Put("  (mixed SSE and VEX)");
+        }
+        OutFile.NewLine();
+    }
+}
+
+void CDisassembler::WriteSectionRecordJSON() {
+    // Write record for current section, JSON Lines
+    OutFile.Put("{\"type\":\"section\",\"index\":");
+    OutFile.PutDecimal(Section);
+    OutFile.Put(",\"name\":");
+    WriteJSONString((char*)NameBuffer.Buf() + Sections[Section].Name);
+    OutFile.Put(",\"address\":");
+    OutFile.PutDecimal(SectionAddress);
+    OutFile.Put(",\"size\":");
+    OutFile.PutDecimal(Sections[Section].InitSize);
+    OutFile.Put(",\"wordsize\":");
+    OutFile.PutDecimal(WordSize);
+    OutFile.Put('}');
+    OutFile.NewLine();
+}
+
+void CDisassembler::WriteFunctionRecordJSON() {
+    // Write record for current function, JSON Lines
+    uint32_t symi = 0;                              // Symbol index
+    OutFile.Put("{\"type\":\"function\",\"index\":");
+    OutFile.PutDecimal(IFunction);
+    if (FunctionList[IFunction].OldSymbolIndex) {
+        symi = Symbols.Old2NewIndex(FunctionList[IFunction].OldSymbolIndex);
+    }
+    if (symi == 0) {
+        // Find symbol at function start
+        symi = Symbols.FindByAddress(Section, FunctionList[IFunction].Start);
+    }
+    if (symi) {
+        OutFile.Put(",\"name\":");
+        WriteJSONString(Symbols.GetName(symi));
+    }
+    OutFile.Put(",\"section\":");
+    OutFile.PutDecimal(Section);
+    OutFile.Put(",\"start\":");
+    OutFile.PutDecimal(FunctionList[IFunction].Start);
+    OutFile.Put(",\"end\":");
+    OutFile.PutDecimal(FunctionEnd);
+    OutFile.Put('}');
+    OutFile.NewLine();
+}
+
+void CDisassembler::WriteRecordTables() {
+    // Write section, function, symbol and string tables after binary records
+    SARecordFileHeader header;                    // File header
+    uint32_t i;                                     // Loop counter
+    uint32_t symi;                                  // Symbol index
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, "OBJCNVR1", 8);
+    header.HeaderSize = sizeof(SARecordFileHeader);
+    header.InstructionRecordSize = sizeof(SAInstructionRecord);
+    header.InstructionOffset = sizeof(SARecordFileHeader);
+    header.NumInstructions = (OutFile.GetDataSize() - header.InstructionOffset) / sizeof(SAInstructionRecord);
+    header.ImageBase = ImageBase;
+
+    // Section table. Entry 0 is empty so that section numbers can be used as index
+    SARecordSection sec;
+    header.SectionOffset = OutFile.GetDataSize();
+    header.NumSections = Sections.GetNumEntries();
+    for (i = 0; i < Sections.GetNumEntries(); i++) {
+        memset(&sec, 0, sizeof(sec));
+        if (i) {
+            sec.Name = RecordString((char*)NameBuffer.Buf() + Sections[i].Name);
+            sec.SectionAddress = Sections[i].SectionAddress;
+            sec.InitSize = Sections[i].InitSize;
+            sec.TotalSize = Sections[i].TotalSize;
+            sec.Type = Sections[i].Type;
+            sec.WordSize = Sections[i].WordSize;
+        }
+        OutFile.Push(&sec, sizeof(sec));
+    }
+
+    // Function table. Entry 0 is empty
+    SARecordFunction fun;
+    header.FunctionOffset = OutFile.GetDataSize();
+    header.NumFunctions = FunctionList.GetNumEntries();
+    for (i = 0; i < FunctionList.GetNumEntries(); i++) {
+        memset(&fun, 0, sizeof(fun));
+        if (i) {
+            fun.Section = FunctionList[i].Section;
+            fun.Start = FunctionList[i].Start;
+            fun.End = FunctionList[i].End;
+            fun.Scope = FunctionList[i].Scope;
+            symi = FunctionList[i].OldSymbolIndex ? Symbols.Old2NewIndex(FunctionList[i].OldSymbolIndex) : 0;
+            if (symi == 0) symi = Symbols.FindByAddress(fun.Section, fun.Start);
+            if (symi) fun.Name = RecordString(Symbols.GetName(symi));
+        }
+        OutFile.Push(&fun, sizeof(fun));
+    }
+
+    // Symbol table. Excluding dummy symbol 0 and section records
+    SARecordSymbol sym;
+    header.SymbolOffset = OutFile.GetDataSize();
+    for (symi = 1; symi < Symbols.GetNumEntries(); symi++) {
+        if (Symbols[symi].Type & 0x80000000) continue;
+        sym.OldIndex = Symbols[symi].OldIndex;
+        sym.Section = Symbols[symi].Section;
+        sym.Offset = Symbols[symi].Offset;
+        sym.Scope = Symbols[symi].Scope;
+        sym.Name = Symbols[symi].Name ? RecordString(Symbols.GetName(symi)) : 0;
+        OutFile.Push(&sym, sizeof(sym));
+        header.NumSymbols++;
+    }
+
+    // String table
+    header.StringTableOffset = OutFile.GetDataSize();
+    header.StringTableSize = RecordStrings.GetDataSize();
+    OutFile.Push(RecordStrings.Buf(), RecordStrings.GetDataSize());
+
+    // Insert header
+    OutFile.Get<SARecordFileHeader>(0) = header;
+}
+
+uint32_t CDisassembler::RecordString(const char * s) {
+    // Put string into RecordStrings. Returns offset
+    return RecordStrings.PushString(s);
+}
+
+void CDisassembler::WriteJSONString(const char * s) {
+    // Write quoted string with JSON escape sequences
+    char text[8];
+    OutFile.Put('"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            OutFile.Put('\\');  OutFile.Put(*s);
+        }
+        else if ((uint8_t)*s < 0x20) {
+            // Control characters
+            sprintf(text, "\\u%04X", (uint8_t)*s);
+            OutFile.Put(text);
+        }
+        else if ((uint8_t)*s >= 0x80) {
+            // Copy a valid UTF-8 sequence unchanged
+            uint8_t c = (uint8_t)*s;
+            int n = 0, j;                           // Number of continuation bytes
+            if (c >= 0xC2 && c <= 0xDF) n = 1;
+            else if (c >= 0xE0 && c <= 0xEF) n = 2;
+            else if (c >= 0xF0 && c <= 0xF4) n = 3;
+            for (j = 1; j <= n; j++) {
+                if (((uint8_t)s[j] & 0xC0) != 0x80) break;
+            }
+            if (n && j > n) {
+                for (j = 0; j <= n; j++) OutFile.Put(s[j]);
+                s += n;
+            }
+            else {
+                // Not valid UTF-8. Write byte as Latin-1 code point
+                sprintf(text, "\\u%04X", c);
+                OutFile.Put(text);
+            }
+        }
+        else {
+            OutFile.Put(*s);
+        }
+    }
+    OutFile.Put('"');
+}
+
+
 void CDisassembler::CountInstructions() {
     // Count total number of instructions defined in opcodes.cpp
     // Two instructions are regarded as the same and counted as one if they 
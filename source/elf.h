@@ -266,6 +266,7 @@ struct Elf64_Shdr {
 #define SHF_INFO_LINK        (1 << 6)  // `sh_info' contains SHT index
 #define SHF_LINK_ORDER       (1 << 7)  // Preserve order after combining
 #define SHF_OS_NONCONFORMING (1 << 8)  // Non-standard OS specific handling required
+#define SHF_GROUP            (1 << 9)  // Section is member of a group
 #define SHF_MASKOS         0x0ff00000  // OS-specific. 
 #define SHF_MASKPROC       0xf0000000  // Processor-specific
 
@@ -412,7 +413,8 @@ struct Elf64_Rel {
 
 // Warning: Elf32_Rela doesn't work in any of the systems I have tried. 
 // Use Elf32_Rel instead with addend in relocated field.
-// Use Elf64_Rela in 64 bit mode. Elf64_Rel not accepted?
+// Use Elf64_Rela in 64 bit mode. The x86-64 linker ignores the relocated field
+// both with Elf64_Rel and Elf64_Rela, so the addend must be in r_addend.
 
 struct Elf32_Rela {
   uint32_t  r_offset;               // Address
@@ -51,7 +51,7 @@ void CELF2COF<ELFSTRUCTURES>::MakeFileHeader() {
    
    // Make PE file header
    NewFileHeader.Machine = (this->WordSize == 32) ? PE_MACHINE_I386 : PE_MACHINE_X8664;
-   NewFileHeader.TimeDateStamp = (uint32_t)time(0);
+   NewFileHeader.TimeDateStamp = cmd.TimeStamp();
    NewFileHeader.SizeOfOptionalHeader = 0;
    NewFileHeader.Flags = 0;
 
@@ -104,6 +104,15 @@ void CELF2COF<ELFSTRUCTURES>::MakeSectionsIndex() {
             cmd.CountExceptionRemoved();
          }
       }
+   }
+
+   if (cmd.SectionGC) {
+      // Remove sections that are not referenced
+      RemoveUnreferencedSections();
+   }
+
+   // Loop through old sections again to make index translation table
+   for (oldsec = 0; oldsec < this->NSections; oldsec++) {
 
       // Search for program data sections only
       if (this->SectionHeaders[oldsec].sh_type == SHT_PROGBITS 
@@ -120,6 +129,386 @@ void CELF2COF<ELFSTRUCTURES>::MakeSectionsIndex() {
 
    // Calculate file offset of raw data
    RawDataOffset = sizeof(SCOFF_FileHeader) + NumSectionsNew * sizeof(SCOFF_SectionHeader);
+
+   // Find COMDAT section groups
+   FindComdatGroups();
+}
+
+
+// FindComdatGroups(): Find ELF COMDAT section groups to convert to COFF COMDAT sections.
+// The section containing the group signature symbol becomes the leader.
+// Other sections in the group become associative to the leader
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+void CELF2COF<ELFSTRUCTURES>::FindComdatGroups() {
+   uint32_t grpsec;                     // Group section in old file
+   uint32_t symsec;                     // Symbol table section of group
+   uint32_t member;                     // Member section in old file
+   uint32_t leader;                     // Leader section of group
+   uint32_t signature;                  // Signature symbol index
+   uint32_t sigsection = 0;             // Section of signature symbol
+   uint32_t NumMembers;                 // Number of entries in group section
+   uint32_t i;                          // Loop counter
+
+   ComdatLeader.SetNum(this->NSections);
+   ComdatLeader.SetZero();
+   ComdatSignature.SetNum(this->NSections);
+   ComdatSignature.SetZero();
+   ComdatSymbol.SetNum(this->NSections);
+   ComdatSymbol.SetZero();
+
+   for (grpsec = 1; grpsec < this->NSections; grpsec++) {
+      TELF_SectionHeader & GroupHeader = this->SectionHeaders[grpsec];
+      if (GroupHeader.sh_type != SHT_GROUP) continue;
+      if (GroupHeader.sh_offset + GroupHeader.sh_size > this->GetDataSize()) {
+         err.submit(2035);  continue;
+      }
+      uint32_t * group = (uint32_t*)(this->Buf() + uint32_t(GroupHeader.sh_offset));
+      NumMembers = uint32_t(GroupHeader.sh_size) / sizeof(uint32_t);
+      if (NumMembers < 2 || !(group[0] & GRP_COMDAT)) continue;  // Not a COMDAT group
+
+      // Find section of signature symbol
+      symsec = GroupHeader.sh_link;  signature = GroupHeader.sh_info;
+      sigsection = 0;
+      if (symsec < this->NSections && this->SectionHeaders[symsec].sh_entsize 
+      && signature < this->SectionHeaders[symsec].sh_size / this->SectionHeaders[symsec].sh_entsize) {
+         TELF_Symbol * sym = (TELF_Symbol*)(this->Buf() + uint32_t(this->SectionHeaders[symsec].sh_offset) 
+            + signature * uint32_t(this->SectionHeaders[symsec].sh_entsize));
+         sigsection = sym->st_shndx;
+      }
+      else {
+         err.submit(2035);  continue;
+      }
+
+      // Choose leader among the members that are converted
+      leader = 0;
+      for (i = 1; i < NumMembers; i++) {
+         member = group[i];
+         if (member >= this->NSections) continue;
+         if (this->SectionHeaders[member].sh_type != SHT_PROGBITS 
+         &&  this->SectionHeaders[member].sh_type != SHT_NOBITS) continue;
+         if (leader == 0 || member == sigsection) leader = member;
+      }
+      if (leader == 0) continue;        // No sections left in group
+
+      // Mark members
+      for (i = 1; i < NumMembers; i++) {
+         member = group[i];
+         if (member >= this->NSections) continue;
+         if (this->SectionHeaders[member].sh_type != SHT_PROGBITS 
+         &&  this->SectionHeaders[member].sh_type != SHT_NOBITS) continue;
+         ComdatLeader[member] = leader;
+      }
+      ComdatSignature[leader] = signature;
+   }
+}
+
+
+// Record in .eh_frame section, used by RemoveUnreferencedSections
+struct SEHFrameRecord {
+   uint32_t Start;                      // Offset of record in section
+   uint32_t End;                        // Offset of end of record
+   uint32_t NewStart;                   // Offset after removing FDEs
+   uint32_t Target;                     // Section of function covered by FDE. 0 for CIE or if unknown
+};
+
+// Find record in .eh_frame section containing offset. Records are sorted by offset.
+// Returns record index, or -1 if not found
+static int FindEHFrameRecord(CSList<SEHFrameRecord> & Records, uint32_t First, uint32_t Last, uint32_t Offset) {
+   while (First < Last) {
+      uint32_t Mid = (First + Last) / 2;
+      if (Offset < Records[Mid].Start) Last = Mid;
+      else if (Offset >= Records[Mid].End) First = Mid + 1;
+      else return Mid;
+   }
+   return -1;
+}
+
+
+// RemoveUnreferencedSections(): Remove sections that cannot be reached from any 
+// public symbol by following relocations.
+// The .eh_frame section is kept, but it does not keep anything alive by itself.
+// The same applies to sections not loaded into memory, such as debug sections.
+// Their relocations to removed sections are removed.
+// An FDE keeps its LSDA etc. alive only if the function it covers is reached.
+// FDEs covering removed sections are removed, as the linker does
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+void CELF2COF<ELFSTRUCTURES>::RemoveUnreferencedSections() {
+   uint32_t oldsec;                     // Section number in old file
+   uint32_t relsec;                     // Relocation section in old file
+   uint32_t symsec = 0;                 // Symbol table section in old file
+   uint32_t symentrysize;               // Size of old symbol table entry
+   uint32_t NumSymbols;                 // Number of old symbols
+   uint32_t w = 0;                      // Index into WorkList
+   uint32_t i;                          // Loop counter
+   int Changed;                         // More sections reached through FDEs
+   TELF_SectionHeader OldRelHeader;     // Old relocation section header
+   TELF_Relocation OldRelocation;       // Old relocation table entry
+   TELF_Symbol OldSym;                  // Old symbol table entry
+   CArrayBuf<uint32_t> RelocationSection; // First relocation section for each old section
+   CArrayBuf<uint32_t> NextRelocationSection; // Next relocation section for the same target section
+   CSList<uint8_t> Reached;             // Section is reachable
+   CSList<uint32_t> WorkList;           // Reached sections whose relocations have not been followed
+   CSList<uint32_t> EHFrameSections;    // .eh_frame sections
+   CSList<uint32_t> NonAllocSections;   // Sections not loaded into memory, e.g. debug
+   CSList<uint32_t> EHFrameFirstRecord; // Index of first record for each .eh_frame section, plus end
+   CSList<SEHFrameRecord> EHRecords;    // CIE and FDE records in .eh_frame sections
+   CSList<uint32_t> EHRelocRecord;      // Record containing each .eh_frame relocation
+   CSList<uint32_t> EHRelocTarget;      // Target section of each .eh_frame relocation
+
+   // Find symbol table
+   for (oldsec = 1; oldsec < this->NSections; oldsec++) {
+      if (this->SectionHeaders[oldsec].sh_type == SHT_SYMTAB) {
+         symsec = oldsec;  break;
+      }
+   }
+   if (symsec == 0) return;             // Error reported by MakeSymbolTable
+   symentrysize = uint32_t(this->SectionHeaders[symsec].sh_entsize);
+   if (symentrysize < sizeof(TELF_Symbol)) symentrysize = sizeof(TELF_Symbol);
+   NumSymbols = uint32_t(this->SectionHeaders[symsec].sh_size) / symentrysize;
+   int8_t * symtab = this->Buf() + uint32_t(this->SectionHeaders[symsec].sh_offset);
+
+   // Find relocation tables for each section. A section may have more than one.
+   // Searching backwards makes each list come out in file order
+   RelocationSection.SetNum(this->NSections);
+   RelocationSection.SetZero();
+   NextRelocationSection.SetNum(this->NSections);
+   NextRelocationSection.SetZero();
+   for (relsec = this->NSections - 1; relsec > 0; relsec--) {
+      OldRelHeader = this->SectionHeaders[relsec];
+      if ((OldRelHeader.sh_type == SHT_REL || OldRelHeader.sh_type == SHT_RELA)
+      && OldRelHeader.sh_info < this->NSections) {
+         NextRelocationSection[relsec] = RelocationSection[OldRelHeader.sh_info];
+         RelocationSection[OldRelHeader.sh_info] = relsec;
+      }
+   }
+
+   Reached.SetNum(this->NSections);
+
+   // Roots: sections that are not subject to removal, and constructor and 
+   // destructor sections.
+   // .eh_frame sections are kept, but their relocations are followed only for 
+   // CIEs and for FDEs of reached functions.
+   // Sections not loaded into memory are kept, but their relocations are not followed
+   for (oldsec = 1; oldsec < this->NSections; oldsec++) {
+      TELF_SectionHeader & OldHeader = this->SectionHeaders[oldsec];
+      const char * sname = "";
+      if (OldHeader.sh_name < this->SecStringTableLen) sname = this->SecStringTable + OldHeader.sh_name;
+      if (OldHeader.sh_type == SHT_PROGBITS && strncmp(sname, ".eh_frame", 9) == 0) {
+         Reached[oldsec] = 1;
+         EHFrameSections.Push(oldsec);
+      }
+      else if (OldHeader.sh_type == SHT_PROGBITS && !(OldHeader.sh_flags & SHF_ALLOC)) {
+         Reached[oldsec] = 1;
+         NonAllocSections.Push(oldsec);
+      }
+      else if ((OldHeader.sh_type != SHT_PROGBITS && OldHeader.sh_type != SHT_NOBITS)
+      || !(OldHeader.sh_flags & SHF_ALLOC)
+      || strncmp(sname, ".ctors", 6) == 0 || strncmp(sname, ".dtors", 6) == 0
+      || strncmp(sname, ".init",  5) == 0 || strncmp(sname, ".fini",  5) == 0) {
+         Reached[oldsec] = 1;
+         if (OldHeader.sh_type != SHT_REMOVE_ME) WorkList.Push(oldsec);
+      }
+   }
+
+   // Split .eh_frame sections into CIE and FDE records
+   for (i = 0; i < EHFrameSections.GetNumEntries(); i++) {
+      oldsec = EHFrameSections[i];
+      uint32_t FirstRecord = EHRecords.GetNumEntries();
+      uint32_t size = uint32_t(this->SectionHeaders[oldsec].sh_size);
+      int8_t * eh = this->Buf() + uint32_t(this->SectionHeaders[oldsec].sh_offset);
+      uint32_t pos = 0;
+      uint32_t length;
+      // Check that the section consists of records with 32-bit length
+      while (pos + 4 <= size) {
+         length = *(uint32_t*)(eh + pos);
+         if (length == 0xFFFFFFFF || length > size - pos - 4) break; // 64-bit length or error
+         pos += 4 + length;
+      }
+      EHFrameFirstRecord.Push(FirstRecord);
+      if (pos != size) {
+         // Cannot interpret section. Keep everything it refers to
+         EHFrameSections[i] = 0;
+         WorkList.Push(oldsec);
+         continue;
+      }
+      SEHFrameRecord Record;
+      Record.NewStart = 0;  Record.Target = 0;
+      for (pos = 0; pos < size; pos = Record.End) {
+         length = *(uint32_t*)(eh + pos);
+         Record.Start = pos;  Record.End = pos + 4 + length;
+         EHRecords.Push(Record);
+      }
+   }
+   EHFrameFirstRecord.Push(EHRecords.GetNumEntries());
+
+   // Find the record and target section of each .eh_frame relocation.
+   // The function covered by an FDE is given by the relocation of the
+   // PC begin field which follows the length and CIE pointer fields
+   for (i = 0; i < EHFrameSections.GetNumEntries(); i++) {
+      oldsec = EHFrameSections[i];
+      if (oldsec == 0) continue;
+      for (relsec = RelocationSection[oldsec]; relsec; relsec = NextRelocationSection[relsec]) {
+         OldRelHeader = this->SectionHeaders[relsec];
+         int8_t * reltab = this->Buf() + uint32_t(OldRelHeader.sh_offset);
+         int8_t * reltabend = reltab + uint32_t(OldRelHeader.sh_size);
+         uint32_t entrysize = uint32_t(OldRelHeader.sh_entsize);
+         uint32_t expectedentrysize = (OldRelHeader.sh_type == SHT_RELA) ? 
+            sizeof(TELF_Relocation) : sizeof(TELF_Relocation) - this->WordSize/8;
+         if (entrysize < expectedentrysize) entrysize = expectedentrysize;
+
+         for (; reltab < reltabend; reltab += entrysize) {
+            memcpy(&OldRelocation, reltab, expectedentrysize);
+            int rec = FindEHFrameRecord(EHRecords, EHFrameFirstRecord[i], EHFrameFirstRecord[i+1], uint32_t(OldRelocation.r_offset));
+            if (rec < 0 || OldRelocation.r_sym >= NumSymbols) continue;
+            OldSym = *(TELF_Symbol*)(symtab + OldRelocation.r_sym * symentrysize);
+            if (OldSym.st_shndx == SHN_UNDEF || OldSym.st_shndx >= this->NSections) continue;
+            SEHFrameRecord & Record = EHRecords[rec];
+            if (OldRelocation.r_offset == Record.Start + 8 
+            && *(uint32_t*)(this->Buf() + uint32_t(this->SectionHeaders[oldsec].sh_offset) + Record.Start + 4) != 0) {
+               // PC begin field of FDE
+               Record.Target = OldSym.st_shndx;
+            }
+            EHRelocRecord.Push(rec);
+            EHRelocTarget.Push(OldSym.st_shndx);
+         }
+      }
+   }
+
+   // Roots: sections containing public symbols
+   for (uint32_t isym = 1; isym < NumSymbols; isym++) {
+      OldSym = *(TELF_Symbol*)(symtab + isym * symentrysize);
+      if (OldSym.st_bind != STB_LOCAL && OldSym.st_shndx != SHN_UNDEF
+      && OldSym.st_shndx < this->NSections && !Reached[OldSym.st_shndx]) {
+         Reached[OldSym.st_shndx] = 1;
+         WorkList.Push(OldSym.st_shndx);
+      }
+   }
+
+   do {
+      // Follow relocations from reached sections. WorkList grows while we go through it
+      for (; w < WorkList.GetNumEntries(); w++) {
+         oldsec = WorkList[w];
+         for (relsec = RelocationSection[oldsec]; relsec; relsec = NextRelocationSection[relsec]) {
+            OldRelHeader = this->SectionHeaders[relsec];
+            int8_t * reltab = this->Buf() + uint32_t(OldRelHeader.sh_offset);
+            int8_t * reltabend = reltab + uint32_t(OldRelHeader.sh_size);
+            uint32_t entrysize = uint32_t(OldRelHeader.sh_entsize);
+            uint32_t expectedentrysize = (OldRelHeader.sh_type == SHT_RELA) ? 
+               sizeof(TELF_Relocation) : sizeof(TELF_Relocation) - this->WordSize/8;
+            if (entrysize < expectedentrysize) entrysize = expectedentrysize;
+
+            for (; reltab < reltabend; reltab += entrysize) {
+               memcpy(&OldRelocation, reltab, expectedentrysize);
+               if (OldRelocation.r_sym >= NumSymbols) continue;
+               OldSym = *(TELF_Symbol*)(symtab + OldRelocation.r_sym * symentrysize);
+               if (OldSym.st_shndx != SHN_UNDEF && OldSym.st_shndx < this->NSections && !Reached[OldSym.st_shndx]) {
+                  // Target section is reached
+                  Reached[OldSym.st_shndx] = 1;
+                  WorkList.Push(OldSym.st_shndx);
+               }
+            }
+         }
+      }
+
+      // Follow relocations from CIEs and from FDEs of reached functions,
+      // e.g. to personality routines and LSDAs
+      Changed = 0;
+      for (i = 0; i < EHRelocRecord.GetNumEntries(); i++) {
+         uint32_t Target = EHRecords[EHRelocRecord[i]].Target;
+         if ((Target == 0 || Reached[Target]) && !Reached[EHRelocTarget[i]]) {
+            Reached[EHRelocTarget[i]] = 1;
+            WorkList.Push(EHRelocTarget[i]);
+            Changed = 1;
+         }
+      }
+   } while (Changed);
+
+   // Remove sections not reached
+   for (oldsec = 1; oldsec < this->NSections; oldsec++) {
+      if (!Reached[oldsec]) {
+         this->SectionHeaders[oldsec].sh_type = SHT_REMOVE_ME;
+         cmd.CountSectionsCollected();
+      }
+   }
+
+   // Remove relocations from non-loaded sections to removed sections
+   for (i = 0; i < NonAllocSections.GetNumEntries(); i++) {
+      oldsec = NonAllocSections[i];
+      for (relsec = RelocationSection[oldsec]; relsec; relsec = NextRelocationSection[relsec]) {
+         OldRelHeader = this->SectionHeaders[relsec];
+         int8_t * reltab = this->Buf() + uint32_t(OldRelHeader.sh_offset);
+         int8_t * reltabend = reltab + uint32_t(OldRelHeader.sh_size);
+         int8_t * newrel = reltab;      // Write pointer
+         uint32_t entrysize = uint32_t(OldRelHeader.sh_entsize);
+         uint32_t expectedentrysize = (OldRelHeader.sh_type == SHT_RELA) ? 
+            sizeof(TELF_Relocation) : sizeof(TELF_Relocation) - this->WordSize/8;
+         if (entrysize < expectedentrysize) entrysize = expectedentrysize;
+
+         for (; reltab < reltabend; reltab += entrysize) {
+            memcpy(&OldRelocation, reltab, expectedentrysize);
+            if (OldRelocation.r_sym < NumSymbols) {
+               OldSym = *(TELF_Symbol*)(symtab + OldRelocation.r_sym * symentrysize);
+               if (OldSym.st_shndx != SHN_UNDEF && OldSym.st_shndx < this->NSections 
+               && !Reached[OldSym.st_shndx]) continue; // Target removed
+            }
+            if (newrel != reltab) memmove(newrel, reltab, entrysize);
+            newrel += entrysize;
+         }
+         this->SectionHeaders[relsec].sh_size = newrel - (this->Buf() + uint32_t(OldRelHeader.sh_offset));
+      }
+   }
+
+   // Remove FDEs of removed sections from .eh_frame sections
+   for (i = 0; i < EHFrameSections.GetNumEntries(); i++) {
+      oldsec = EHFrameSections[i];
+      if (oldsec == 0) continue;
+      int8_t * eh = this->Buf() + uint32_t(this->SectionHeaders[oldsec].sh_offset);
+      uint32_t pos = 0;                 // New size of section
+      uint32_t rec;                     // Record index
+      for (rec = EHFrameFirstRecord[i]; rec < EHFrameFirstRecord[i+1]; rec++) {
+         SEHFrameRecord & Record = EHRecords[rec];
+         if (Record.Target && !Reached[Record.Target]) continue; // Remove this FDE
+         uint32_t CIEPointer = *(uint32_t*)(eh + Record.Start + 4);
+         Record.NewStart = pos;
+         if (pos != Record.Start) {
+            memmove(eh + pos, eh + Record.Start, Record.End - Record.Start);
+            if (CIEPointer && Record.End - Record.Start >= 8) {
+               // FDE. Adjust distance back to its CIE, which is never removed
+               int cie = FindEHFrameRecord(EHRecords, EHFrameFirstRecord[i], rec, Record.Start + 4 - CIEPointer);
+               if (cie >= 0) *(uint32_t*)(eh + pos + 4) = pos + 4 - EHRecords[cie].NewStart;
+            }
+         }
+         pos += Record.End - Record.Start;
+      }
+      if (pos == uint32_t(this->SectionHeaders[oldsec].sh_size)) continue; // Nothing removed
+      this->SectionHeaders[oldsec].sh_size = pos;
+
+      // Remove relocations of removed FDEs and adjust the rest
+      for (relsec = RelocationSection[oldsec]; relsec; relsec = NextRelocationSection[relsec]) {
+         OldRelHeader = this->SectionHeaders[relsec];
+         int8_t * reltab = this->Buf() + uint32_t(OldRelHeader.sh_offset);
+         int8_t * reltabend = reltab + uint32_t(OldRelHeader.sh_size);
+         int8_t * newrel = reltab;      // Write pointer
+         uint32_t entrysize = uint32_t(OldRelHeader.sh_entsize);
+         uint32_t expectedentrysize = (OldRelHeader.sh_type == SHT_RELA) ? 
+            sizeof(TELF_Relocation) : sizeof(TELF_Relocation) - this->WordSize/8;
+         if (entrysize < expectedentrysize) entrysize = expectedentrysize;
+
+         for (; reltab < reltabend; reltab += entrysize) {
+            memcpy(&OldRelocation, reltab, expectedentrysize);
+            int r = FindEHFrameRecord(EHRecords, EHFrameFirstRecord[i], EHFrameFirstRecord[i+1], uint32_t(OldRelocation.r_offset));
+            if (r >= 0) {
+               SEHFrameRecord & Record = EHRecords[r];
+               if (Record.Target && !Reached[Record.Target]) continue; // Relocation in removed FDE
+               OldRelocation.r_offset -= Record.Start - Record.NewStart; // Records only move down
+            }
+            memmove(newrel, reltab, entrysize);
+            memcpy(newrel, &OldRelocation, expectedentrysize);
+            newrel += entrysize;
+         }
+         this->SectionHeaders[relsec].sh_size = newrel - (this->Buf() + uint32_t(OldRelHeader.sh_offset));
+      }
+   }
 }
 
 
@@ -133,8 +522,58 @@ void CELF2COF<ELFSTRUCTURES>::MakeSections() {
    TELF_SectionHeader OldRelHeader;     // Old relocation section header
    TELF_Relocation OldRelocation;       // Old relocation table entry
    SCOFF_Relocation NewRelocation;  // New relocation table entry
+   uint32_t RawDataSize = 0;          // Size of raw data and relocations in new file
+   uint32_t NumRelocations;           // Number of relocation entries in old relocation section
+   int entrysize;                     // Size of old relocation entry
+   int expectedentrysize;             // Minimum size of old relocation entry
+   CArrayBuf<uint32_t> RelocationSection; // First relocation section for each old section
+   CArrayBuf<uint32_t> NextRelocationSection; // Next relocation section for the same target section
+
+   // Find relocation tables for each section in one pass rather than searching
+   // through all sections for every section. A section may have more than one
+   // relocation table. Searching backwards makes each list come out in file order
+   RelocationSection.SetNum(this->NSections);
+   RelocationSection.SetZero();
+   NextRelocationSection.SetNum(this->NSections);
+   NextRelocationSection.SetZero();
+   for (relsec = this->NSections - 1; relsec > 0; relsec--) {
+      OldRelHeader = this->SectionHeaders[relsec];
+      if ((OldRelHeader.sh_type == SHT_REL || OldRelHeader.sh_type == SHT_RELA) // if section is relocation
+      && OldRelHeader.sh_info < this->NSections) {
+         NextRelocationSection[relsec] = RelocationSection[OldRelHeader.sh_info];
+         RelocationSection[OldRelHeader.sh_info] = relsec;
+      }
+   }
 
-   // Loop through old sections
+   // First pass: Compute the size of raw data and relocation entries, so that
+   // the output buffer can be allocated once and the sections written directly into it
+   for (oldsec = 0; oldsec < this->NSections; oldsec++) {
+      OldHeader = this->SectionHeaders[oldsec];
+      if (OldHeader.sh_type == SHT_PROGBITS || OldHeader.sh_type == SHT_NOBITS) {
+         if (OldHeader.sh_size && OldHeader.sh_type != SHT_NOBITS) {
+            RawDataSize += (uint32_t(OldHeader.sh_size) + 3) & uint32_t(-4);
+         }
+         for (relsec = RelocationSection[oldsec]; relsec; relsec = NextRelocationSection[relsec]) {
+            OldRelHeader = this->SectionHeaders[relsec];
+            entrysize = uint32_t(OldRelHeader.sh_entsize);
+            expectedentrysize = (OldRelHeader.sh_type == SHT_RELA) ? 
+               sizeof(TELF_Relocation) : sizeof(TELF_Relocation) - this->WordSize/8;
+            if (entrysize < expectedentrysize) entrysize = expectedentrysize;
+            NumRelocations = (uint32_t(OldRelHeader.sh_size) + entrysize - 1) / entrysize;
+            RawDataSize += (NumRelocations * SIZE_SCOFF_Relocation + 3) & uint32_t(-4);
+         }
+      }
+   }
+
+   // Allocate space for raw data, symbol table and string table in one buffer.
+   // The string table may still grow by long section names
+   ToFile.SetSize(RawDataOffset + RawDataSize + NewSymbolTable.GetDataSize() 
+      + NewStringTable.GetDataSize() + this->SecStringTableLen);
+
+   // Make space for section headers after file header. Raw data follow at RawDataOffset
+   ToFile.Push(0, NumSectionsNew * sizeof(SCOFF_SectionHeader));
+
+   // Second pass: Loop through old sections
    for (oldsec = 0; oldsec < this->NSections; oldsec++) {
 
       // Copy old header for convenience
@@ -166,11 +605,11 @@ void CELF2COF<ELFSTRUCTURES>::MakeSections() {
          NewHeader.SizeOfRawData = uint32_t(OldHeader.sh_size);  // section size in file
          if (OldHeader.sh_size && OldHeader.sh_type != SHT_NOBITS) {
             // File  to raw data for section
-            NewHeader.PRawData = NewRawData.GetDataSize() + RawDataOffset;
+            NewHeader.PRawData = ToFile.GetDataSize();
 
             // Copy raw data
-            NewRawData.Push(this->Buf()+(uint32_t)(OldHeader.sh_offset), (uint32_t)(OldHeader.sh_size)); 
-            NewRawData.Align(4);
+            ToFile.Push(this->Buf()+(uint32_t)(OldHeader.sh_offset), (uint32_t)(OldHeader.sh_size)); 
+            ToFile.Align(4);
          }
 
          // Section flags
@@ -188,186 +627,184 @@ void CELF2COF<ELFSTRUCTURES>::MakeSections() {
          if (NewAlign > 14) NewAlign = 14;   // limit for highest alignment
          NewHeader.Flags |= PE_SCN_ALIGN_1 * NewAlign;
 
-         // Find relocation table for this section by searching through all sections
-         for (relsec = 1; relsec < this->NSections; relsec++) {
+         // Section belongs to a COMDAT group
+         if (ComdatLeader[oldsec]) NewHeader.Flags |= PE_SCN_LNK_COMDAT;
+
+         // Loop through relocation tables for this section
+         for (relsec = RelocationSection[oldsec]; relsec; relsec = NextRelocationSection[relsec]) {
 
             // Get section header
             OldRelHeader = this->SectionHeaders[relsec];
 
-            // Check if this is a relocations section referring to oldsec
-            if ((OldRelHeader.sh_type == SHT_REL || OldRelHeader.sh_type == SHT_RELA) // if section is relocation
-            && OldRelHeader.sh_info == oldsec) { // and if section refers to current section
-
-               // Found the right relocation table. Get pointer
-               int8_t * reltab = this->Buf() + uint32_t(OldRelHeader.sh_offset);
-               int8_t * reltabend = reltab + uint32_t(OldRelHeader.sh_size);
-
-               // Get entry size
-               int entrysize = uint32_t(OldRelHeader.sh_entsize);
-               int expectedentrysize = (OldRelHeader.sh_type == SHT_RELA) ? 
-                  sizeof(TELF_Relocation) :                    // Elf32_Rela, Elf64_Rela
-                  sizeof(TELF_Relocation) - this->WordSize/8;  // Elf32_Rel,  Elf64_Rel
-               if (entrysize < expectedentrysize) {err.submit(2033); entrysize = expectedentrysize;}
+            // Found the right relocation table. Get pointer
+            int8_t * reltab = this->Buf() + uint32_t(OldRelHeader.sh_offset);
+            int8_t * reltabend = reltab + uint32_t(OldRelHeader.sh_size);
 
-               // File pointer for new relocations
-               NewHeader.PRelocations = NewRawData.GetDataSize() + RawDataOffset;   // file  to relocation entries
+            // Get entry size
+            entrysize = uint32_t(OldRelHeader.sh_entsize);
+            expectedentrysize = (OldRelHeader.sh_type == SHT_RELA) ? 
+               sizeof(TELF_Relocation) :                    // Elf32_Rela, Elf64_Rela
+               sizeof(TELF_Relocation) - this->WordSize/8;  // Elf32_Rel,  Elf64_Rel
+            if (entrysize < expectedentrysize) {err.submit(2033); entrysize = expectedentrysize;}
 
-               // Loop through relocation table entries
-               for (; reltab < reltabend; reltab += entrysize) {
+            // File pointer for new relocations. Relocations from all tables are contiguous
+            if (NewHeader.NRelocations == 0) {
+               NewHeader.PRelocations = ToFile.GetDataSize();   // file  to relocation entries
+            }
 
-                  // Copy relocation table entry with or without addend
-                  OldRelocation.r_addend = 0;
-                  memcpy(&OldRelocation, reltab, entrysize); 
+            // Loop through relocation table entries
+            for (; reltab < reltabend; reltab += entrysize) {
 
-                  // Find inline addend
-                  uint32_t InlinePosition = (uint32_t)(NewHeader.PRawData - RawDataOffset + OldRelocation.r_offset);
+               // Copy relocation table entry with or without addend
+               OldRelocation.r_addend = 0;
+               memcpy(&OldRelocation, reltab, entrysize); 
 
-                  // Check that address is valid
-                  if (InlinePosition >= this->GetDataSize()) {
-                     // Address is invalid
-                     err.submit(2032);
-                     break;
-                  }
+               // Check that address is valid
+               if (NewHeader.PRawData == 0 || OldRelocation.r_offset >= OldHeader.sh_size) {
+                  // Address is invalid
+                  err.submit(2032);
+                  break;
+               }
 
-                  // Pointer to inline addend
-                  int32_t * piaddend = (int32_t*)(NewRawData.Buf() + InlinePosition);
+               // Pointer to inline addend in new file
+               int32_t * piaddend = (int32_t*)(ToFile.Buf() + NewHeader.PRawData + uint32_t(OldRelocation.r_offset));
 
-                  // Symbol offset
-                  NewRelocation.VirtualAddress = uint32_t(OldRelocation.r_offset);
+               // Symbol offset
+               NewRelocation.VirtualAddress = uint32_t(OldRelocation.r_offset);
 
-                  // Symbol table index
-                  if (OldRelocation.r_sym < NewSymbolIndex.GetNumEntries()) { 
-                     NewRelocation.SymbolTableIndex = NewSymbolIndex[OldRelocation.r_sym];
-                  }
-                  else {
-                     NewRelocation.SymbolTableIndex = 0; // Symbol table index out of range
-                  }
+               // Symbol table index
+               if (OldRelocation.r_sym < NewSymbolIndex.GetNumEntries()) { 
+                  NewRelocation.SymbolTableIndex = NewSymbolIndex[OldRelocation.r_sym];
+               }
+               else {
+                  NewRelocation.SymbolTableIndex = 0; // Symbol table index out of range
+               }
 
-                  // Get relocation type and fix addend
-                  if (this->WordSize == 32) {
-                     switch(OldRelocation.r_type) {
-                     case R_386_NONE:    // Ignored
-                        NewRelocation.Type = COFF32_RELOC_ABS;  break;
-
-                     case R_386_IRELATIVE:
-                        err.submit(1063); // Warning: Gnu indirect function cannot be converted
-                        // continue in next case?:
-                     case R_386_32:      // 32-bit absolute virtual address
-                        NewRelocation.Type = COFF32_RELOC_DIR32;  
-                        *piaddend += uint32_t(OldRelocation.r_addend);  
-                        break;
+               // Get relocation type and fix addend
+               if (this->WordSize == 32) {
+                  switch(OldRelocation.r_type) {
+                  case R_386_NONE:    // Ignored
+                     NewRelocation.Type = COFF32_RELOC_ABS;  break;
+
+                  case R_386_IRELATIVE:
+                     err.submit(1063); // Warning: Gnu indirect function cannot be converted
+                     // continue in next case?:
+                  case R_386_32:      // 32-bit absolute virtual address
+                     NewRelocation.Type = COFF32_RELOC_DIR32;  
+                     *piaddend += uint32_t(OldRelocation.r_addend);  
+                     break;
 
-                     case R_386_PC32:   // 32-bit self-relative
-                        NewRelocation.Type = COFF32_RELOC_REL32;  
-                        // Difference between EIP-relative and self-relative relocation = size of address field
-                        // Adjust inline addend for different relocation method:
-                        *piaddend += 4 + uint32_t(OldRelocation.r_addend);
-                        break;
+                  case R_386_PC32:   // 32-bit self-relative
+                     NewRelocation.Type = COFF32_RELOC_REL32;  
+                     // Difference between EIP-relative and self-relative relocation = size of address field
+                     // Adjust inline addend for different relocation method:
+                     *piaddend += 4 + uint32_t(OldRelocation.r_addend);
+                     break;
 
-                     case R_386_GOT32: case R_386_GLOB_DAT: case R_386_GOTOFF: case R_386_GOTPC:
-                        // Global offset table
-                        err.submit(2042);     // cannot convert position-independent code
-                        err.ClearError(2042); // report this error only once
-                        NewRelocation.Type = 0;
-                        break;
+                  case R_386_GOT32: case R_386_GLOB_DAT: case R_386_GOTOFF: case R_386_GOTPC:
+                     // Global offset table
+                     err.submit(2042);     // cannot convert position-independent code
+                     err.ClearError(2042); // report this error only once
+                     NewRelocation.Type = 0;
+                     break;
 
-                     case R_386_PLT32: case R_386_JMP_SLOT: 
-                        // procedure linkage table
-                        err.submit(2043);     // cannot convert import table
-                        err.ClearError(2043); // report this error only once
-                        NewRelocation.Type = 0;
-                        break;
+                  case R_386_PLT32: case R_386_JMP_SLOT: 
+                     // procedure linkage table
+                     err.submit(2043);     // cannot convert import table
+                     err.ClearError(2043); // report this error only once
+                     NewRelocation.Type = 0;
+                     break;
 
-                     case R_386_RELATIVE:  // adjust by program base
-                     default:              // Unknown or unsupported relocation method
-                        err.submit(2030, OldRelocation.r_type); 
-                        err.ClearError(2030); // report this error only once
-                        NewRelocation.Type = 0; 
-                        break;
-                     }
+                  case R_386_RELATIVE:  // adjust by program base
+                  default:              // Unknown or unsupported relocation method
+                     err.submit(2030, OldRelocation.r_type); 
+                     err.ClearError(2030); // report this error only once
+                     NewRelocation.Type = 0; 
+                     break;
                   }
-                  else { // WordSize == 64
-                     switch(OldRelocation.r_type) {
-                     case R_X86_64_NONE:     // Ignored
-                        NewRelocation.Type = COFF64_RELOC_ABS;  
-                        break;
+               }
+               else { // WordSize == 64
+                  switch(OldRelocation.r_type) {
+                  case R_X86_64_NONE:     // Ignored
+                     NewRelocation.Type = COFF64_RELOC_ABS;  
+                     break;
 
-                     case R_X86_64_64:      // 64 bit absolute virtual addres
-                        NewRelocation.Type = COFF64_RELOC_ABS64;  
-                        *(int64_t*)piaddend += OldRelocation.r_addend;  
-                        break;
+                  case R_X86_64_64:      // 64 bit absolute virtual addres
+                     NewRelocation.Type = COFF64_RELOC_ABS64;  
+                     *(int64_t*)piaddend += OldRelocation.r_addend;  
+                     break;
 
-                     case R_X86_64_IRELATIVE:
-                        err.submit(1063); // Warning: Gnu indirect function cannot be converted
-                        // continue in next case?:
-                     case R_X86_64_32S:     // 32 bit absolute virtual address, sign extended
-                     case R_X86_64_32:      // 32 bit absolute virtual address, zero extended
-                        NewRelocation.Type = COFF64_RELOC_ABS32;  
-                        *piaddend += uint32_t(OldRelocation.r_addend);  
-                        break;
+                  case R_X86_64_IRELATIVE:
+                     err.submit(1063); // Warning: Gnu indirect function cannot be converted
+                     // continue in next case?:
+                  case R_X86_64_32S:     // 32 bit absolute virtual address, sign extended
+                  case R_X86_64_32:      // 32 bit absolute virtual address, zero extended
+                     NewRelocation.Type = COFF64_RELOC_ABS32;  
+                     *piaddend += uint32_t(OldRelocation.r_addend);  
+                     break;
 
-                     case R_X86_64_PC32:    // 32 bit, self-relative
-                        // See COFF2ELF.cpp for an explanation of the difference between
-                        // COFF and ELF relative relocation methods
-                        *piaddend += uint32_t(OldRelocation.r_addend);
-                        if (*piaddend >= -8 && *piaddend <= -4) {
-                           NewRelocation.Type = (uint16_t)(COFF64_RELOC_REL32 - *piaddend - 4);  
-                           *piaddend = 0;
-                        }
-                        else {
-                           NewRelocation.Type = COFF64_RELOC_REL32;
-                           *piaddend += 4;
-                        }
-                        break;
+                  case R_X86_64_PC32:    // 32 bit, self-relative
+                     // See COFF2ELF.cpp for an explanation of the difference between
+                     // COFF and ELF relative relocation methods
+                     *piaddend += uint32_t(OldRelocation.r_addend);
+                     if (*piaddend >= -8 && *piaddend <= -4) {
+                        NewRelocation.Type = (uint16_t)(COFF64_RELOC_REL32 - *piaddend - 4);  
+                        *piaddend = 0;
+                     }
+                     else {
+                        NewRelocation.Type = COFF64_RELOC_REL32;
+                        *piaddend += 4;
+                     }
+                     break;
 
-                     case R_X86_64_RELATIVE:  // Adjust by program base
-                        err.submit(2030, OldRelocation.r_type); 
-                        err.ClearError(2030); // report this error only once
-                        NewRelocation.Type = 0;
-                        break;
+                  case R_X86_64_RELATIVE:  // Adjust by program base
+                     err.submit(2030, OldRelocation.r_type); 
+                     err.ClearError(2030); // report this error only once
+                     NewRelocation.Type = 0;
+                     break;
 
-                     case R_X86_64_GOT32: case R_X86_64_GLOB_DAT: case R_X86_64_GOTPCREL:
-                        // Global offset table
-                        err.submit(2042);     // cannot convert position-independent code
-                        err.ClearError(2042); // report this error only once
-                        NewRelocation.Type = 0;
-                        break;
+                  case R_X86_64_GOT32: case R_X86_64_GLOB_DAT: case R_X86_64_GOTPCREL:
+                     // Global offset table
+                     err.submit(2042);     // cannot convert position-independent code
+                     err.ClearError(2042); // report this error only once
+                     NewRelocation.Type = 0;
+                     break;
 
-                     case R_X86_64_PLT32: case R_X86_64_JUMP_SLOT: 
-                        // procedure linkage table
-                        err.submit(2042);     // cannot convert import table
-                        err.ClearError(2043); // report this error only once
-                        NewRelocation.Type = 0;
-                        break;
+                  case R_X86_64_PLT32: case R_X86_64_JUMP_SLOT: 
+                     // procedure linkage table
+                     err.submit(2042);     // cannot convert import table
+                     err.ClearError(2043); // report this error only once
+                     NewRelocation.Type = 0;
+                     break;
 
-                     default:              // Unknown or unsupported relocation method
-                        err.submit(2030, OldRelocation.r_type); 
-                        err.ClearError(2030); // report this error only once
-                        NewRelocation.Type = 0; 
-                        break;
-                     }
+                  default:              // Unknown or unsupported relocation method
+                     err.submit(2030, OldRelocation.r_type); 
+                     err.ClearError(2030); // report this error only once
+                     NewRelocation.Type = 0; 
+                     break;
                   }
+               }
 
-                  // Store relocation entry
-                  NewRawData.Push(&NewRelocation, SIZE_SCOFF_Relocation);
-                  NewHeader.NRelocations++;
+               // Store relocation entry
+               ToFile.Push(&NewRelocation, SIZE_SCOFF_Relocation);
+               NewHeader.NRelocations++;
 
-                  // Remember that symbol is used
-                  if (OldRelocation.r_type) {
-                     SymbolsUsed[NewRelocation.SymbolTableIndex]++;
-                  }                                  
+               // Remember that symbol is used
+               if (OldRelocation.r_type) {
+                  SymbolsUsed[NewRelocation.SymbolTableIndex]++;
+               }                                  
 
-               } // End of relocations loop
+            } // End of relocations loop
 
-            } // End of if right relocation table
 
-         } // End of search for relocation table
+         } // End of relocation tables loop
 
          // Align raw data for next section
-         NewRawData.Align(4);
+         ToFile.Align(4);
 
-         // Store section header in file
-         ToFile.Push(&NewHeader, sizeof(NewHeader));
+         // Store section header in the space reserved after the file header
+         memcpy(ToFile.Buf() + sizeof(SCOFF_FileHeader) + NewSectIndex[oldsec] * sizeof(SCOFF_SectionHeader),
+            &NewHeader, sizeof(NewHeader));
 
       } // End of if section has program data
 
@@ -412,6 +849,7 @@ void CELF2COF<ELFSTRUCTURES>::MakeSymbolTable() {
 
    // Initialize new string table. make space for 4-bytes size
    NewStringTable.Push(0, 4);
+   NewStringTable.SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of long names
 
    // Loop through old sections to find symbol table
    for (oldsec = 0; oldsec < this->NSections; oldsec++) {
@@ -438,6 +876,11 @@ void CELF2COF<ELFSTRUCTURES>::MakeSymbolTable() {
          symtabsize = uint32_t(OldHeader.sh_size);
          symtabend = symtab + symtabsize;
 
+         if (FoundSymTab == 1) {
+            // Put section symbols and signature symbols of COMDAT sections first
+            MakeComdatSymbols(symtab, symtabsize / entrysize, entrysize, strtab, stringtabsize);
+         }
+
          // Loop through old symbol table
          for (OldSymI = 0; symtab < symtabend; symtab += entrysize, OldSymI++) {
 
@@ -450,6 +893,18 @@ void CELF2COF<ELFSTRUCTURES>::MakeSymbolTable() {
             // New symbol index
             NewSymI = NewSymbolTable.GetNumEntries(); 
 
+            // Section symbols and signature symbols of COMDAT sections have already been stored
+            if (FoundSymTab == 1 && OldSym.st_shndx < this->NSections && ComdatLeader[OldSym.st_shndx]) {
+               if (OldSym.st_type == STT_SECTION) {
+                  NewSymbolIndex.Push(ComdatSymbol[OldSym.st_shndx]);
+                  continue;
+               }
+               if (ComdatLeader[OldSym.st_shndx] == OldSym.st_shndx && ComdatSignature[OldSym.st_shndx] == OldSymI) {
+                  NewSymbolIndex.Push(ComdatSymbol[OldSym.st_shndx] + 2);
+                  continue;
+               }
+            }
+
             // Symbol type
             int type = OldSym.st_type;
 
@@ -484,6 +939,12 @@ void CELF2COF<ELFSTRUCTURES>::MakeSymbolTable() {
             else if (OldSym.st_shndx >= this->NSections) {
                err.submit(2036, OldSym.st_shndx); // Special/unknown section index or out of range
             }
+            else if (this->SectionHeaders[OldSym.st_shndx].sh_type == SHT_REMOVE_ME
+            ||  this->SectionHeaders[OldSym.st_shndx].sh_type == SHT_GROUP) {
+               // Section has been removed, or symbol names a section group. Remove symbol
+               if (FoundSymTab == 1) NewSymbolIndex.Push(0);
+               continue;
+            }
             else {
                // Normal section index. 
                // Look up in section index translation table and add 1 because it is 1-based
@@ -499,6 +960,10 @@ void CELF2COF<ELFSTRUCTURES>::MakeSymbolTable() {
                NewSym.s.StorageClass = COFF_CLASS_EXTERNAL; break;
 
             case STB_WEAK:
+               if (OldSym.st_shndx < this->NSections && ComdatLeader[OldSym.st_shndx]) {
+                  // Weak definition in COMDAT section. Duplicates are removed with the section
+                  NewSym.s.StorageClass = COFF_CLASS_EXTERNAL; break;
+               }
                err.submit(1051, symname); // Weak public symbol not supported
                NewSym.s.StorageClass = COFF_CLASS_WEAK_EXTERNAL; break;
 
@@ -628,11 +1093,81 @@ void CELF2COF<ELFSTRUCTURES>::MakeSymbolTable() {
 }
 
 
+// MakeComdatSymbols(): Make section definition records for COMDAT sections, each 
+// followed by the COMDAT symbol for the leader section of the group
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+void CELF2COF<ELFSTRUCTURES>::MakeComdatSymbols(int8_t * symtab, uint32_t NumSymbols, uint32_t entrysize, char * strtab, uint32_t stringtabsize) {
+   uint32_t oldsec;                      // Section number in old file
+   uint32_t leader;                      // Leader section of COMDAT group
+   SCOFF_SymTableEntry NewSym;           // New symbol table record
+   SCOFF_SymTableEntry AuxSym;           // Auxiliary symbol table entry
+   TELF_Symbol OldSym;                   // Signature symbol
+
+   for (oldsec = 1; oldsec < this->NSections; oldsec++) {
+      leader = ComdatLeader[oldsec];
+      if (leader == 0) continue;
+      TELF_SectionHeader * OldSecHdr = &(this->SectionHeaders[oldsec]);
+
+      // Section definition record
+      memset(&NewSym, 0, sizeof(NewSym));
+      const char * sname = "";
+      if (OldSecHdr->sh_name < this->SecStringTableLen) sname = this->SecStringTable + OldSecHdr->sh_name;
+      COFF_PutNameInSymbolTable(NewSym, sname, NewStringTable);
+      NewSym.s.SectionNumber = (int16_t)(NewSectIndex[oldsec] + 1);
+      NewSym.s.StorageClass = COFF_CLASS_STATIC;
+      NewSym.s.NumAuxSymbols = 1;
+      ComdatSymbol[oldsec] = NewSymbolTable.GetNumEntries();
+      NewSymbolTable.Push(&NewSym, SIZE_SCOFF_SymTableEntry);
+
+      // Auxiliary record with COMDAT selection
+      memset(&AuxSym, 0, sizeof(AuxSym));
+      AuxSym.section.Length = uint32_t(OldSecHdr->sh_size);
+      if (oldsec + 1 < this->NSections 
+      && (OldSecHdr[1].sh_type == SHT_REL || OldSecHdr[1].sh_type == SHT_RELA)
+      && OldSecHdr[1].sh_info == oldsec && OldSecHdr[1].sh_entsize > 0) {
+         AuxSym.section.NumberOfRelocations = (uint16_t)(uint32_t(OldSecHdr[1].sh_size) / uint32_t(OldSecHdr[1].sh_entsize));
+      }
+      if (leader == oldsec) {
+         AuxSym.section.Selection = IMAGE_COMDAT_SELECT_ANY;
+      }
+      else {
+         AuxSym.section.Selection = IMAGE_COMDAT_SELECT_ASSOCIATIVE;
+         AuxSym.section.Number = (uint16_t)(NewSectIndex[leader] + 1);
+      }
+      NewSymbolTable.Push(&AuxSym, SIZE_SCOFF_SymTableEntry);
+
+      if (leader != oldsec) continue;
+
+      // COMDAT symbol named by the group signature
+      memset(&NewSym, 0, sizeof(NewSym));
+      memset(&OldSym, 0, sizeof(OldSym));
+      if (ComdatSignature[oldsec] < NumSymbols) {
+         OldSym = *(TELF_Symbol*)(symtab + ComdatSignature[oldsec] * entrysize);
+      }
+      if (OldSym.st_type != STT_SECTION && OldSym.st_name && OldSym.st_name < stringtabsize) {
+         sname = strtab + OldSym.st_name;
+      }
+      COFF_PutNameInSymbolTable(NewSym, sname, NewStringTable);
+      NewSym.s.SectionNumber = (int16_t)(NewSectIndex[oldsec] + 1);
+      if (OldSym.st_shndx == oldsec && OldSym.st_type != STT_SECTION) {
+         NewSym.s.Value = uint32_t(OldSym.st_value);
+      }
+      NewSym.s.Type = (OldSym.st_type == STT_FUNC) ? COFF_TYPE_FUNCTION : COFF_TYPE_NOT_FUNCTION;
+      // Public unless signature is a local symbol or defined in a section outside the group.
+      // A signature symbol defined in the group section itself names the group only
+      int GroupSymbol = OldSym.st_shndx < this->NSections && this->SectionHeaders[OldSym.st_shndx].sh_type == SHT_GROUP;
+      NewSym.s.StorageClass = ((OldSym.st_bind != STB_LOCAL || GroupSymbol)
+         && (OldSym.st_shndx == oldsec || OldSym.st_shndx == SHN_UNDEF || GroupSymbol)) ? COFF_CLASS_EXTERNAL : COFF_CLASS_STATIC;
+      NewSymbolTable.Push(&NewSym, SIZE_SCOFF_SymTableEntry);
+   }
+}
+
+
 // HideUnusedSymbols(): Hide unused symbols if stripping debug info or exception info
 template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
 void CELF2COF<ELFSTRUCTURES>::HideUnusedSymbols() {
 
-   if (cmd.DebugInfo != CMDL_DEBUG_STRIP && cmd.ExeptionInfo != CMDL_EXCEPTION_STRIP) {
+   if (cmd.DebugInfo != CMDL_DEBUG_STRIP && cmd.ExeptionInfo != CMDL_EXCEPTION_STRIP && !cmd.SectionGC) {
       // No sections removed. Do nothing
       return;
    }
@@ -679,16 +1214,13 @@ void CELF2COF<ELFSTRUCTURES>::MakeBinaryFile() {
 
    // Update file header
    NewFileHeader.NumberOfSections = (uint16_t)NumSectionsNew;
-   NewFileHeader.PSymbolTable = RawDataOffset + NewRawData.GetDataSize();
+   NewFileHeader.PSymbolTable = ToFile.GetDataSize();
    NewFileHeader.NumberOfSymbols = NewSymbolTable.GetNumEntries();
 
    // Replace file header in new file with updated version
    memcpy(ToFile.Buf(), &NewFileHeader, sizeof(NewFileHeader));
 
-   // Section headers have already been inserted.
-   // Insert raw data in file
-   ToFile.Push(NewRawData.Buf(), NewRawData.GetDataSize());
-
+   // Section headers, raw data and relocations have already been inserted.
    // Insert symbol table
    ToFile.Push(NewSymbolTable.Buf(), NewSymbolTable.GetDataSize());
 
@@ -29,7 +29,10 @@ void CELF2ELF<ELFSTRUCTURES>::Convert() {
    // according to the so-called two-phase lookup rule.
    MakeSymbolTable();               // Remake symbol tables and string tables
    ChangeSections();                // Modify section names and relocation table symbol indices
-   MakeBinaryFile();                // Put everyting together into ToFile
+   if (this->FileHeader.e_shentsize != sizeof(TELF_SectionHeader)
+   || PatchBinaryFile()) {          // Put new tables into old file without moving other sections if they fit
+      MakeBinaryFile();             // Put everyting together into ToFile
+   }
    *this << ToFile;                 // Take over new file buffer
 }
 
@@ -110,7 +113,11 @@ void CELF2ELF<ELFSTRUCTURES>::MakeSymbolTable() {
          char * StringTable = (char*)this->Buf() + this->SectionHeaders[istrtab[isymt]].sh_offset;
          uint32_t StringTableLen = uint32_t(this->SectionHeaders[istrtab[isymt]].sh_size);
 
-         NewStringTable[isymt].Push(0, 1); // Initialize new string table, first entry 0
+         // Initialize new string table with a copy of the old one, so that unchanged 
+         // names keep their offsets. Only changed names are added
+         if (StringTableLen) NewStringTable[isymt].Push(StringTable, StringTableLen);
+         else NewStringTable[isymt].Push(0, 1); // First entry 0
+         NewStringTable[isymt].SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of names
 
          if (isymt == 0) {
             // Allocate NewSymbolIndex
@@ -193,9 +200,10 @@ void CELF2ELF<ELFSTRUCTURES>::MakeSymbolTable() {
                err.submit(9000); // unknown error
             }
 
-            // Add entry to new string table
+            // Add entry to new string table if name changed
             if (name1 && *name1) {
-               symnamei = NewStringTable[isymt].PushString(name1);
+               if (action == SYMA_CHANGE_NAME) symnamei = NewStringTable[isymt].PushString(name1);
+               else symnamei = sym.st_name;  // Name is in the copy of old string table
             }
             else {
                symnamei = 0;
@@ -270,8 +278,11 @@ void CELF2ELF<ELFSTRUCTURES>::ChangeSections() {
    TELF_Relocation * relocp;        // Pointer to relocation entry
    uint32_t oldsymi, newsymi;     // Relocation symbol index
 
-   // Initialize section header string table .shstrtab. First entry = 0
-   NewStringTable[2].Push(0, 1);
+   // Initialize section header string table .shstrtab with a copy of the old one,
+   // so that it is unchanged if no section names are changed
+   if (this->SecStringTableLen) NewStringTable[2].Push(this->SecStringTable, this->SecStringTableLen);
+   else NewStringTable[2].Push(0, 1);       // First entry = 0
+   NewStringTable[2].SetSuffixMerge(cmd.SuffixMerge);
 
    // Loop through sections
    SectionHeaderOffset = uint32_t(this->FileHeader.e_shoff);
@@ -288,13 +299,11 @@ void CELF2ELF<ELFSTRUCTURES>::ChangeSections() {
 
       // Check if name change
       action = cmd.SymbolChange(name1, &name2, SYMT_SECTION);
-      if (action == SYMA_CHANGE_NAME) name1 = name2;
-
-      // Store name in .shstrtab string table
-      if (name1 && *name1) {
-         namei = NewStringTable[2].PushString(name1);
+      if (action == SYMA_CHANGE_NAME && name2 && *name2) {
+         // Store changed name in .shstrtab string table
+         namei = NewStringTable[2].PushString(name2);
       }
-      else {
+      else if (action == SYMA_CHANGE_NAME) {
          namei = 0;
       }
       sheaderp->sh_name = namei;   // Put new string index into section header
@@ -419,6 +428,97 @@ void CELF2ELF<ELFSTRUCTURES>::MakeBinaryFile() {
 }
 
 
+// PatchBinaryFile()
+template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
+int CELF2ELF<ELFSTRUCTURES>::PatchBinaryFile() {
+   // Put the new symbol tables and string tables into the old file without moving
+   // any other section. Section headers and relocation tables have already been 
+   // modified in place by ChangeSections.
+   // Each table must fit into its old place, including any alignment gap after it.
+   // Return value is 0 if success. If a table does not fit then nothing is done and 
+   // the return value is 1. The file must then be rebuilt by MakeBinaryFile.
+   uint32_t SectionNumber;               // Section number
+   uint32_t SectionHeaderOffset;         // File offset to section header
+   TELF_SectionHeader * sheaderp;      // Pointer to section header
+   CMemoryBuffer * NewTable;           // New contents of modified section
+   uint32_t NewSize;                     // Size of new contents
+   uint32_t Offset;                      // File offset of new contents
+   uint64_t End;                         // End of old table
+   uint64_t Limit;                       // End of space available for table
+   uint32_t i;                           // Section number
+   int pass;                             // 0: check that tables fit, 1: store tables
+
+   for (pass = 0; pass < 2; pass++) {
+
+      // Loop through sections, except the null section
+      SectionHeaderOffset = uint32_t(this->FileHeader.e_shoff);
+      for (SectionNumber = 1; SectionNumber < this->NSections; SectionNumber++) {
+         SectionHeaderOffset += this->FileHeader.e_shentsize;
+
+         // Check for sections that have been modified, in the same order as MakeBinaryFile
+         if (SectionNumber == isymtab[0]) {
+            NewTable = &NewSymbolTable[0];          // Static symbol table .symtab
+         }
+         else if (SectionNumber == isymtab[1]) {
+            NewTable = &NewSymbolTable[1];          // Dynamic symbol table .dynsym
+         }
+         else if (SectionNumber == istrtab[0]) {
+            NewTable = &NewStringTable[0];          // Symbol string table .strtab
+         }
+         else if (SectionNumber == istrtab[1]) {
+            NewTable = &NewStringTable[1];          // Dynamic symbol string table
+         }
+         else if (SectionNumber == istrtab[2]) {
+            NewTable = &NewStringTable[2];          // Section name string table .shstrtab
+         }
+         else {
+            continue;                               // Any other section is not moved
+         }
+         NewSize = NewTable->GetDataSize();
+         sheaderp = (TELF_SectionHeader*)(this->Buf() + SectionHeaderOffset);
+         Offset = uint32_t(sheaderp->sh_offset);
+         End = sheaderp->sh_offset + sheaderp->sh_size;
+
+         if (pass == 0) {
+            // Find space at old place, including any alignment gap before the next
+            // section, the section headers, the program headers or the end of file
+            if (End > this->GetDataSize()) return 1;
+            if (NewSize <= sheaderp->sh_size) continue;
+            Limit = this->GetDataSize();
+            if (this->FileHeader.e_shoff >= End && this->FileHeader.e_shoff < Limit) {
+               Limit = this->FileHeader.e_shoff;
+            }
+            if (this->FileHeader.e_phnum && this->FileHeader.e_phoff >= End && this->FileHeader.e_phoff < Limit) {
+               Limit = this->FileHeader.e_phoff;
+            }
+            for (i = 1; i < this->NSections; i++) {
+               TELF_SectionHeader & other = this->SectionHeaders[i];
+               if (i == SectionNumber || other.sh_type == SHT_NOBITS || other.sh_size == 0) continue;
+               if (other.sh_offset + other.sh_size > sheaderp->sh_offset && other.sh_offset < Limit) {
+                  if (other.sh_offset < End) return 1;  // Overlapping sections
+                  Limit = other.sh_offset;
+               }
+            }
+            if (NewSize > Limit - sheaderp->sh_offset) return 1; // Does not fit
+         }
+         else {
+            // Store new table at old place. Fill the rest with zeroes
+            memcpy(this->Buf() + Offset, NewTable->Buf(), NewSize);
+            if (NewSize < sheaderp->sh_size) {
+               memset(this->Buf() + Offset + NewSize, 0, uint32_t(sheaderp->sh_size) - NewSize);
+            }
+            sheaderp->sh_size = NewSize;
+            if (SectionNumber == isymtab[0]) sheaderp->sh_info = FirstGlobalSymbol;
+         }
+      }
+   }
+
+   // Take over old file buffer. Nothing is copied
+   *this >> ToFile;
+   return 0;
+}
+
+
 // Make template instances for 32 and 64 bits
 template class CELF2ELF<ELF32STRUCTURES>;
 template class CELF2ELF<ELF64STRUCTURES>;
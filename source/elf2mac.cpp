@@ -43,6 +43,7 @@ template <class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class
 void CELF2MAC<ELFSTRUCTURES,MACSTRUCTURES>::MakeFileHeader() {
    // Convert subfunction: Make file header and load segment command
    TMAC_header NewHeader;                             // new file header
+   memset(&NewHeader, 0, sizeof(NewHeader));          // Reserved field must be zero
    NewHeader.magic      = (this->WordSize == 32) ? MAC_MAGIC_32 : MAC_MAGIC_64; // Mach magic number identifier
    NewHeader.cputype    = (this->WordSize == 32) ? MAC_CPU_TYPE_I386 : MAC_CPU_TYPE_X86_64;
    NewHeader.cpusubtype = MAC_CPU_SUBTYPE_I386_ALL;
@@ -816,6 +817,10 @@ void CELF2MAC<ELFSTRUCTURES,MACSTRUCTURES>::MakeSections() {
    uint32_t NewRawDataOffset = 0;    // Offset into NewRawData of section. 
    // NewRawDataOffset is different from NewVirtualAddress if alignment of sections in 
    // the object file is different from alignment of sections in memory
+   uint32_t RawDataSize = 0;         // Total size of raw data
+   uint32_t NumRelocations = 0;      // Total number of relocations
+   CArrayBuf<uint32_t> RelocationSection; // First relocation section for each old section
+   CArrayBuf<uint32_t> NextRelocationSection; // Next relocation section for the same target section
 
    // Count cumulative number of symbols in each scope
    NumSymbols[0] = 0;
@@ -826,6 +831,34 @@ void CELF2MAC<ELFSTRUCTURES,MACSTRUCTURES>::MakeSections() {
 
    NewSectHeadOffset = ToFile.GetDataSize();
 
+   // Find relocation tables for each section in one pass, and count
+   // raw data and relocations so that the buffers are allocated only once.
+   // A section may have more than one relocation table.
+   // Searching backwards makes each list come out in file order
+   RelocationSection.SetNum(this->NSections);
+   RelocationSection.SetZero();
+   NextRelocationSection.SetNum(this->NSections);
+   NextRelocationSection.SetZero();
+   for (relsec = this->NSections - 1; relsec > 0; relsec--) {
+      OldRelHeader = this->SectionHeaders[relsec];
+      if ((OldRelHeader.sh_type == SHT_REL || OldRelHeader.sh_type == SHT_RELA) // if section is relocation
+      && OldRelHeader.sh_info < this->NSections) {
+         NextRelocationSection[relsec] = RelocationSection[OldRelHeader.sh_info];
+         RelocationSection[OldRelHeader.sh_info] = relsec;
+         if (OldRelHeader.sh_entsize) {
+            NumRelocations += uint32_t(OldRelHeader.sh_size / OldRelHeader.sh_entsize);
+         }
+      }
+   }
+   for (oldsec = 0; oldsec < this->NSections; oldsec++) {
+      OldHeader = this->SectionHeaders[oldsec];
+      if (OldHeader.sh_type == SHT_PROGBITS) {
+         RawDataSize += (uint32_t(OldHeader.sh_size) + 3) & uint32_t(-4);
+      }
+   }
+   NewRawData.SetSize(RawDataSize);
+   NewRelocationTab.SetSize(NumRelocations * sizeof(MAC_relocation_info));
+
    // Second loop through old sections
    for (oldsec = 0; oldsec < this->NSections; oldsec++) {
 
@@ -922,18 +955,11 @@ void CELF2MAC<ELFSTRUCTURES,MACSTRUCTURES>::MakeSections() {
          NewHeader.addr = NewVirtualAddress; 
          NewVirtualAddress += (uint32_t)OldHeader.sh_size;
 
-         // Find relocation table for this section by searching through all sections
-         for (relsec = 1; relsec < this->NSections; relsec++) {
-
-            // Get section header
-            OldRelHeader = this->SectionHeaders[relsec];            
-            
-            // Check if this is a relocations section referring to oldsec
-            if ((OldRelHeader.sh_type == SHT_REL || OldRelHeader.sh_type == SHT_RELA) // if section is relocation
-            && OldRelHeader.sh_info == oldsec) { // and if section refers to current section
-               Elf2MacRelocations(OldRelHeader, NewHeader, NewRawDataOffset, oldsec);
-            }
-         } // End of search for relocation table
+         // Find relocation tables for this section
+         for (relsec = RelocationSection[oldsec]; relsec; relsec = NextRelocationSection[relsec]) {
+            OldRelHeader = this->SectionHeaders[relsec];
+            Elf2MacRelocations(OldRelHeader, NewHeader, NewRawDataOffset, oldsec);
+         }
 
          // Align raw data for next section
          NewRawData.Align(4);
@@ -1034,6 +1060,7 @@ void CELF2MAC<ELFSTRUCTURES,MACSTRUCTURES>::MakeBinaryFile() {
 
    // Initialize new string table. First string is empty
    NewStringTable.Push(0, 1);
+   NewStringTable.SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of names
 
    // Store symbol tables and make string table
    // Tables are not sorted alphabetically yet. This will be done subsequently
@@ -56,6 +56,7 @@ SErrorText ErrorTexts[] = {
    {1061, 1, "Symbol %s has lazy binding"},
    {1062, 1, "Symbol %s has unknown type"},
    {1063, 1, "Gnu indirect function (CPU dispatcher) cannot be converted"},
+   {1064, 1, "Option -gc is supported only for conversion from ELF to COFF. Ignored"},
    {1101, 1, "Output file name should have extension .lib or .a"},
    {1102, 1, "Library members have different type"},
    {1103, 1, "Output file name ignored"},
@@ -65,6 +66,7 @@ SErrorText ErrorTexts[] = {
    {1107, 1, "Name of library member %s should have extension .o or .obj"},
    {1108, 1, "Name of library member %s too long. Truncating to 15 characters"},
    {1109, 1, "Library member %s has unknown type. Possibly alias record without code"},
+   {1110, 1, "Function %s not found. Nothing disassembled for this name"},
    {1150, 1, "Universal binary contains more than one component that can be converted. Specify desired word size or use lipo to extract desired component"},
    {1151, 1, "Skipping component with wordsize %i"},
 
@@ -171,10 +173,15 @@ SErrorText ErrorTexts[] = {
    {2505, 2, "Object file word size (%i) does not match library"},
    {2506, 2, "Overflow of buffer for library member names"},
    {2507, 2, "%s is an import library. Cannot convert to static library"},
+   {2508, 2, "Library has no symbol index. Use -d to list public names of all members"},
+   {2509, 2, "Library member %s is not an unmodified object file. Cannot put it in thin archive"},
+   {2510, 2, "Cannot make path of %s relative to location of thin archive"},
+   {2511, 2, "Thin archive can only contain ELF files"},
    {2600, 2, "Library has more than one header"},
    {2601, 2, "Library page size (%i) is not a power of 2"},
    {2602, 2, "Library end record does not match dictionary offset in OMF library"},
    {2603, 2, "Public name %s not found in hash table"},
+   {2604, 2, "Hash table block %i has invalid string entry"},
    {2605, 2, "Symbol hash table too big. Creation of library failed"},
    {2606, 2, "Too many library members. Creation of library failed"},
    {2610, 2, "Library end record not found"},
@@ -24,6 +24,8 @@ CLibrary::CLibrary() {
     // Constructor
     CurrentOffset = 0;
     CurrentNumber = 0;
+    MemberHeader = 0;
+    MemberPath = 0;
     LongNames = 0;
     LongNamesSize = 0;
     AlignBy = 0;
@@ -41,12 +43,24 @@ void CLibrary::Go() {
     int FileType1 = 0;             // File type of current member
     int WordSize1 = 0;             // Word size of current member
 
+    if (cmd.LibraryOptions & CMDL_LIBRARY_FINDSYMBOL) {
+        // Find symbols in library index without reading members
+        FindSymbols();
+        return;
+    }
+
     if (cmd.DumpOptions && !(cmd.LibraryOptions & CMDL_LIBRARY_EXTRACTMEM)) {
         // Dump library, but not its members
         Dump();
         return;
     }
 
+    if (cmd.LibraryOptions == CMDL_LIBRARY_EXTRACTMEM && cmd.InputType == FILETYPE_LIBRARY) {
+        // Extract specified members only. Other members are not read
+        ExtractSelectedMembers();
+        return;
+    }
+
     // Remove path form member names and check member type before extracting or adding members
     AlignBy = 2;
     if (GetDataSize()) FixNames();    
@@ -152,6 +166,8 @@ void CLibrary::Go() {
         } */
         MemberBuffer.FileName = MemberName1;
         MemberBuffer.OutputFileName = MemberName2 ? MemberName2 : MemberName1;
+        // Object file of member if input is a thin archive
+        MemberPath = IsThinArchive() ? (char*)ThinPath.Buf() : 0;
 
         if (action == SYMA_DELETE_MEMBER) {
             // Remove this member from library
@@ -180,6 +196,7 @@ void CLibrary::Go() {
                 // Conversion or name change requested
                 MemberBuffer.Go();                   // Do required conversion
                 if (err.Number()) break;             // Stop if error
+                MemberPath = 0;                      // Member is no longer the same as its object file
                 // Check type again after conversion
                 FileType1 = MemberBuffer.GetFileType();
                 if (MemberBuffer.OutputFileName == 0 || FileType1 != FileType0) {
@@ -205,45 +222,7 @@ void CLibrary::Go() {
             // Extract member(s)
             if (action == SYMA_EXTRACT_MEMBER || cmd.LibraryOptions == CMDL_LIBRARY_EXTRACTALL) {
                 // Extract this member
-                if (cmd.DumpOptions == 0 && cmd.OutputType != CMDL_OUTPUT_DUMP) {
-                    // Write this member to file
-                    if (err.Number()) return; // Check first if error
-
-                    if (cmd.SymbolChangesRequested() || FileType1 != cmd.OutputType) {
-                        // Conversion or name change requested
-
-                        // Check type before conversion
-                        int FileType0 = MemberBuffer.GetFileType();
-                        MemberBuffer.Go();
-                        if (err.Number()) return; // Stop if error
-                        // Check type after conversion
-                        FileType1 = MemberBuffer.GetFileType();
-                        if (MemberBuffer.OutputFileName == 0 /*|| FileType1 != FileType0*/) {
-                            MemberBuffer.OutputFileName = MemberBuffer.SetFileNameExtension(MemberBuffer.FileName);
-                        }
-                    }
-                    if (MemberBuffer.OutputFileName == 0) {
-                        MemberBuffer.OutputFileName = MemberBuffer.FileName;
-                    }
-                    if (cmd.Verbose) {
-                        // Tell what we are doing
-                        if (MemberName1 == MemberName2) {
-                            printf("\nExtracting file %s from library", MemberName1);
-                        }
-                        else {
-                            printf("\nExtracting library member %s to file %s", MemberName1, MemberBuffer.OutputFileName);
-                        }
-                    }
-                    if (WordSize1 == 0) {
-                        err.submit(1109, MemberName1);
-                    }
-                    // Write this member to file
-                    MemberBuffer.Write();
-                }
-                else {
-                    // Dump this member
-                    MemberBuffer.Go();
-                }
+                if (ExtractMemberToFile(MemberName1, MemberName2)) return;
             }
         }
         else if (cmd.DumpOptions == 0) {
@@ -290,6 +269,8 @@ void CLibrary::Go() {
                     printf(". Converting from %s.", GetFileFormatName(NewMemberType));
                 }
             }
+            // Object file can be referenced from thin archive only if not modified
+            MemberPath = (NewMemberType == cmd.OutputType && !cmd.SymbolChangesRequested()) ? sym->Name2 : 0;
             // Do any conversion required
             MemberBuffer.Go();
 
@@ -331,6 +312,129 @@ void CLibrary::Go() {
     }
 }
 
+int CLibrary::ExtractMemberToFile(char const * MemberName1, char const * MemberName2) {
+    // Write library member in MemberBuffer to file, or dump it.
+    // Conversion is done if requested. Returns nonzero if extraction must stop
+    int FileType1 = MemberBuffer.GetFileType();   // File type of member
+    int WordSize1 = MemberBuffer.WordSize;        // Word size of member
+
+    if (cmd.DumpOptions == 0 && cmd.OutputType != CMDL_OUTPUT_DUMP) {
+        // Write this member to file
+        if (err.Number()) return 1; // Check first if error
+
+        if (cmd.SymbolChangesRequested() || FileType1 != cmd.OutputType) {
+            // Conversion or name change requested
+
+            // Check type before conversion
+            int FileType0 = MemberBuffer.GetFileType();
+            MemberBuffer.Go();
+            if (err.Number()) return 1; // Stop if error
+            // Check type after conversion
+            FileType1 = MemberBuffer.GetFileType();
+            if (MemberBuffer.OutputFileName == 0 /*|| FileType1 != FileType0*/) {
+                MemberBuffer.OutputFileName = MemberBuffer.SetFileNameExtension(MemberBuffer.FileName);
+            }
+        }
+        if (MemberBuffer.OutputFileName == 0) {
+            MemberBuffer.OutputFileName = MemberBuffer.FileName;
+        }
+        if (cmd.Verbose) {
+            // Tell what we are doing
+            if (MemberName1 == MemberName2) {
+                printf("\nExtracting file %s from library", MemberName1);
+            }
+            else {
+                printf("\nExtracting library member %s to file %s", MemberName1, MemberBuffer.OutputFileName);
+            }
+        }
+        if (WordSize1 == 0) {
+            err.submit(1109, MemberName1);
+        }
+        // Write this member to file
+        MemberBuffer.Write();
+    }
+    else {
+        // Dump this member
+        MemberBuffer.Go();
+    }
+    return 0;
+}
+
+
+void CLibrary::ExtractSelectedMembers() {
+    // Extract members specified with -lx:name from UNIX style library.
+    // The member headers are scanned first to find the requested names, so that
+    // only the requested members are copied, identified and converted
+    char * MemberName1;                           // Name of library member
+    char const * MemberName2;                     // Name of extracted file
+    SLibraryNameQuery Query;                      // Member name to find
+    SSymbolChange const * sym;                    // Member name from command line
+    int32_t q;                                    // Index into NameQueries
+    uint32_t i;                                   // Loop counter
+
+    if (cmd.Verbose) {
+        printf("\nExtracting from library file: %s", FileName);
+    }
+
+    // Make sorted list of member names to find
+    while ((sym = cmd.GetLibraryRequest(SYMA_EXTRACT_MEMBER)) != 0) {
+        Query.Name = sym->Name1;
+        Query.Member = Query.Count = 0;
+        NameQueries.PushUnique(Query);
+    }
+
+    // Scan member headers. Only the first member is read, because the member type
+    // is needed for fixing the names
+    StartExtracting();
+    while ((MemberName1 = ExtractMember(cmd.MemberType ? 0 : &MemberBuffer)) != 0) {
+        if (cmd.MemberType == 0) {
+            // Check if import library
+            if (MemberBuffer.Get<uint32_t>(0) == 0xFFFF0000) {
+                err.submit(2507, cmd.InputFile);  return;
+            }
+            // Remember member type and word size
+            cmd.MemberType = MemberBuffer.GetFileType();
+            if (cmd.DesiredWordSize == 0) {
+                cmd.DesiredWordSize = MemberBuffer.WordSize;
+            }
+            if (cmd.OutputType == FILETYPE_LIBRARY) {
+                cmd.OutputType = cmd.MemberType;
+            }
+        }
+        if (MemberName1[0] == '/') continue;     // names record
+        // Remove path from name, as in StripMemberNamesUNIX
+        StripMemberName(MemberName1);
+        Query.Name = MemberName1;
+        q = NameQueries.Exists(Query);
+        if (q >= 0) {
+            // Requested member found. A later member with the same name overrides it
+            NameQueries[q].Member = MemberHeader;
+            NameQueries[q].Count++;
+        }
+    }
+    if (err.Number()) return;
+
+    // Extract the members found
+    for (i = 0; i < NameQueries.GetNumEntries(); i++) {
+        if (NameQueries[i].Count == 0) continue;  // Not found. Warning comes in CheckExtractSuccess
+        // Read member at saved position
+        CurrentOffset = NameQueries[i].Member;
+        MemberName1 = ExtractMember(&MemberBuffer);
+        if (MemberName1 == 0) break;
+        // Get output name and mark as done
+        cmd.SymbolChange(MemberName1, &MemberName2, SYMT_LIBRARYMEMBER);
+        MemberBuffer.FileName = MemberName1;
+        MemberBuffer.OutputFileName = MemberName2 ? MemberName2 : MemberName1;
+        if (MemberBuffer.GetFileType() == 0) continue;
+        // Write or dump member
+        if (ExtractMemberToFile(MemberName1, MemberName2)) return;
+    }
+    if (err.Number()) return; 
+
+    cmd.CheckExtractSuccess();                    // Check if members to extract were found
+}
+
+
 void CLibrary::FixNames() {
     // Rebuild library or fix member names
     // Dispatch according to library type
@@ -680,6 +784,7 @@ void CLibrary::DumpUNIX() {
     CurrentOffset = 8;  CurrentNumber = 0;
 
     printf("\nDump of library %s", cmd.InputFile);
+    if (IsThinArchive()) printf(". Thin archive");
 
     if (cmd.DumpOptions & DUMP_SECTHDR) {
         // dump headers
@@ -713,7 +818,7 @@ void CLibrary::DumpUNIX() {
                 printf("\nLongnames header \"%s\". Offset 0x%X, size 0x%X", Name,
                     CurrentOffset + (uint32_t)sizeof(SUNIXLibraryHeader), MemberSize);
             }
-            else if (Name[0] == '/' && Name[1] <= ' ') {
+            else if ((Name[0] == '/' && Name[1] <= ' ') || strncmp(Name, "/SYM64/", 7) == 0) {
                 // Symbol index
                 printf("\nSymbol index %i, \"%s\"", ++symindex, Name);
             }
@@ -741,7 +846,7 @@ void CLibrary::DumpUNIX() {
     printf("\n\nExported symbols by member:\n");
 
     // Loop through library
-    while (CurrentOffset + sizeof(SUNIXLibraryHeader) < DataSize) {
+    while (CurrentOffset + sizeof(SUNIXLibraryHeader) <= DataSize) {
 
         // Reset buffers
         StringBuffer.SetSize(0);
@@ -844,6 +949,10 @@ uint32_t CLibrary::NextHeader(uint32_t Offset) {
 
     // Size of member
     MemberSize = atoi(Header->FileSize);
+    if (MemberIsExternal(Header)) {
+        // Thin archive. Member data is in a separate file
+        MemberSize = 0;
+    }
     if (MemberSize < 0 || MemberSize + Offset + sizeof(SUNIXLibraryHeader) > DataSize) {
         err.submit(2500);  // Points outside file
         return 0;
@@ -865,6 +974,21 @@ uint32_t CLibrary::NextHeader(uint32_t Offset) {
 }
 
 
+int CLibrary::IsThinArchive() {
+    // Check if input is a GNU thin archive
+    return GetDataSize() >= 8 && strncmp((char*)Buf(), "!<thin>\n", 8) == 0;
+}
+
+
+int CLibrary::MemberIsExternal(SUNIXLibraryHeader * Header) {
+    // Check if member data is in a separate file.
+    // In a thin archive, only the symbol index and longnames members are stored in the archive
+    if (!IsThinArchive()) return 0;
+    return !(strncmp(Header->Name, "/ ", 2) == 0 || strncmp(Header->Name, "// ", 3) == 0
+        || strncmp(Header->Name, "/SYM64/", 7) == 0);
+}
+
+
 void CLibrary::StartExtracting() {
     // Initialize before ExtractMember() 
     if (cmd.InputType == FILETYPE_OMFLIBRARY) {
@@ -974,10 +1098,12 @@ char * CLibrary::ExtractMemberUNIX(CFileBuffer * Destination) {
     uint32_t NameIndex;                   // Index into long names member
     char * Name = 0;                    // Name of member
     int Skip = 1;                       // Skip record and search for next
+    int External = 0;                   // Member data is in a separate file (thin archive)
+    char const * PathName = 0;          // Path of separate file
     int i;                              // Loop counter
     char * p;                           // Used for loop through string
 
-    if (CurrentOffset == 0 || CurrentOffset + sizeof(SUNIXLibraryHeader) >= DataSize) {
+    if (CurrentOffset == 0 || CurrentOffset + sizeof(SUNIXLibraryHeader) > DataSize) {
         // No more members
         return 0;
     }
@@ -989,12 +1115,15 @@ char * CLibrary::ExtractMemberUNIX(CFileBuffer * Destination) {
         Header = &Get<SUNIXLibraryHeader>(CurrentOffset);
         // Size of member
         MemberSize = (uint32_t)atoi(Header->FileSize);
-        if (MemberSize + CurrentOffset + sizeof(SUNIXLibraryHeader) > DataSize) {
+        // Check if member data is in a separate file
+        External = MemberIsExternal(Header);
+        if (!External && MemberSize + CurrentOffset + sizeof(SUNIXLibraryHeader) > DataSize) {
             err.submit(2500);  // Points outside file
             return 0;
         }
         // Member name
         Name = Header->Name;
+        PathName = Name;
         if (strncmp(Name, "// ", 3) == 0) {
             // This is the long names member. Remember its position
             LongNames = CurrentOffset + sizeof(SUNIXLibraryHeader);
@@ -1003,15 +1132,29 @@ char * CLibrary::ExtractMemberUNIX(CFileBuffer * Destination) {
             // but may contain non-terminating '/'. Find out which type we have:
             // Pointer to LongNames record
             p = (char*)Buf() + LongNames;
-            // Find out whether we have terminating zeroes:
-            if ((LongNamesSize > 1 && p[LongNamesSize-1] == '/') || (p[LongNamesSize-1] <= ' ' && p[LongNamesSize-2] == '/')) {
+            // Find out whether we have terminating zeroes.
+            // Skip any padding after the last name:
+            uint32_t LastChar = LongNamesSize;
+            while (LastChar > 1 && p[LastChar-1] <= ' ') LastChar--;
+            if (LastChar == LongNamesSize && LongNamesSize > 1 && p[LongNamesSize-1] == '/') {
                 // Names are terminated by '/'. Replace all '/' by 0 in the longnames record
                 for (uint32_t j = 0; j < LongNamesSize; j++, p++) {
                     if (*p == '/') *p = 0;
                 }
             }
+            else if (LastChar < LongNamesSize && p[LastChar-1] == '/') {
+                // Names are terminated by "/\n". Replace the terminating '/' by 0.
+                // Any other '/' is part of a path, as in thin archives
+                for (uint32_t j = 0; j + 1 < LongNamesSize; j++, p++) {
+                    if (p[0] == '/' && p[1] == '\n') *p = 0;
+                }
+            }
+            if (IsThinArchive() && ThinNames.GetDataSize() == 0) {
+                // Save paths of member files before the names are modified
+                ThinNames.Push(Buf() + LongNames, LongNamesSize);
+            }
         }
-        else if (strncmp(Name, "/ ", 2) == 0
+        else if (strncmp(Name, "/ ", 2) == 0 || strncmp(Name, "/SYM64/", 7) == 0
             || strncmp(Name, "__.SYMDEF", 9) == 0) {
                 // This is a symbol index member.
                 // The symbol index is not used because we are always building a new symbol index.
@@ -1021,6 +1164,11 @@ char * CLibrary::ExtractMemberUNIX(CFileBuffer * Destination) {
             NameIndex = atoi(Name+1);
             if (NameIndex < LongNamesSize) {
                 Name = (char*)Buf() + LongNames + NameIndex;
+                PathName = Name;
+                if (NameIndex < ThinNames.GetDataSize()) {
+                    // Unmodified path of member file in thin archive
+                    PathName = (char*)ThinNames.Buf() + NameIndex;
+                }
             }
             else {
                 Name = (char*)"NoName!";
@@ -1056,17 +1204,40 @@ char * CLibrary::ExtractMemberUNIX(CFileBuffer * Destination) {
             Name[16] = 0;
             Skip = 0;
         }
+        // Remember header position
+        MemberHeader = CurrentOffset;
         // Point to next member
         CurrentOffset = NextHeader(CurrentOffset);
         // Increment number
         CurrentNumber += !Skip;
     }  // End of while loop
 
+    if (External) {
+        // Thin archive. The path of the member file is relative to the directory of the archive
+        ThinPath.SetSize(0);
+        if (PathName[0] != '/' && PathName[0] != '\\' && !(PathName[0] && PathName[1] == ':')) {
+            // Relative path. Prefix directory of archive
+            uint32_t DirLength = 0;
+            for (i = 0; cmd.InputFile[i]; i++) {
+                if (cmd.InputFile[i] == '/' || cmd.InputFile[i] == '\\') DirLength = i + 1;
+            }
+            ThinPath.Push(cmd.InputFile, DirLength);
+        }
+        ThinPath.PushString(PathName);
+    }
+
     // Save member as raw data
     if (Destination) {
         Destination->SetSize(0);       // Make sure destination buffer is empty
         Destination->FileType = Destination->WordSize = 0;
-        Destination->Push((int8_t*)Header + sizeof(SUNIXLibraryHeader) + HeaderExtra, MemberSize);
+        if (External) {
+            // Read member from its own file
+            Destination->FileName = (char*)ThinPath.Buf();
+            Destination->Read();
+        }
+        else {
+            Destination->Push((int8_t*)Header + sizeof(SUNIXLibraryHeader) + HeaderExtra, MemberSize);
+        }
     }
 
     // Check name
@@ -1134,7 +1305,18 @@ void CLibrary::InsertMemberUNIX(CFileBuffer * member) {
     // Name of member
     if (member->OutputFileName == 0 || *member->OutputFileName == 0) member->OutputFileName = member->FileName;
 
-    if (cmd.LibrarySubtype == LIBTYPE_SHORTNAMES) {
+    if (cmd.LibrarySubtype == LIBTYPE_THIN) {
+        // Thin archive. The name is the path of the object file
+        if (member->GetFileType() != FILETYPE_ELF) {
+            err.submit(2511);  return;
+        }
+        if (MemberPath == 0) {
+            // Member does not exist as a file
+            err.submit(2509, member->OutputFileName);  return;
+        }
+        name = (char*)ThinMemberPath(MemberPath);
+    }
+    else if (cmd.LibrarySubtype == LIBTYPE_SHORTNAMES) {
         // Make short name
         name = ShortenMemberName(member->OutputFileName);
     }
@@ -1151,6 +1333,12 @@ void CLibrary::InsertMemberUNIX(CFileBuffer * member) {
         NameAfter = NameLength + pad;
         sprintf(header.Name, "#1/%i ", NameAfter);
     }
+    else if (cmd.LibrarySubtype == LIBTYPE_THIN) {
+        // Thin archive stores all paths in LongNamesBuffer, terminated by "/\n"
+        i = LongNamesBuffer.Push(name, NameLength);
+        LongNamesBuffer.Push("/\n", 2);
+        sprintf(header.Name, "/%i ", i);
+    }
     else {
         // ELF and COFF library store names < 16 characters in the name field
         if (NameLength < 16) {
@@ -1177,7 +1365,7 @@ void CLibrary::InsertMemberUNIX(CFileBuffer * member) {
     }
 
     // Date
-    sprintf(header.Date, "%u ", (uint32_t)time(0));
+    sprintf(header.Date, "%u ", cmd.TimeStamp());
 
     // User and group id
     header.UserID[0] = '0';
@@ -1187,7 +1375,7 @@ void CLibrary::InsertMemberUNIX(CFileBuffer * member) {
     // Size of binary file
     RawSize = member->GetDataSize();
     // Calculate alignment padding
-    if (AlignBy) {
+    if (AlignBy && cmd.LibrarySubtype != LIBTYPE_THIN) {
         AlignmentPadding = uint32_t(-int32_t(RawSize)) & (AlignBy-1);
     }
 
@@ -1219,8 +1407,10 @@ void CLibrary::InsertMemberUNIX(CFileBuffer * member) {
         DataBuffer.Align(AlignBy);
     }
 
-    // Store member
-    DataBuffer.Push(member->Buf(), RawSize);
+    // Store member, except in thin archive
+    if (cmd.LibrarySubtype != LIBTYPE_THIN) {
+        DataBuffer.Push(member->Buf(), RawSize);
+    }
 
     // Align by padding with '\n'
     for (uint32_t i = 0; i < AlignmentPadding; i++) {
@@ -1567,22 +1757,39 @@ void CLibrary::SortStringTable() {
     SStringEntry * Table = &StringEntries[0];
     // String pointers
     char * s1, * s2;
-    // Temporary record for swapping
-    SStringEntry temp;
-
-    // Simple Bubble sort:
-    int32_t i, j;
-    for (i = 0; i < n; i++) {
-        for (j = 0; j < n - i - 1; j++) {
-            s1 = (char*)StringBuffer.Buf() + Table[j].String;
-            s2 = (char*)StringBuffer.Buf() + Table[j+1].String;
-            if (strcmp(s1, s2) > 0) {
-                // Swap records
-                temp = Table[j];
-                Table[j] = Table[j+1];
-                Table[j+1] = temp;
+    // Strings
+    char * Strings = (char*)StringBuffer.Buf();
+
+    // Merge sort, bottom up. The sort must be stable so that symbols with the
+    // same name stay in member order, as the old bubble sort did.
+    // The records are merged back and forth between Table and TempTable
+    CArrayBuf<SStringEntry> TempTable;
+    TempTable.SetNum(n);
+    SStringEntry * Source = Table, * Dest = &TempTable[0], * Swap;
+    int32_t i, j, d, k, Width, Mid, End;
+    for (Width = 1; Width < n; Width *= 2) {
+        for (k = 0; k < n; k += 2 * Width) {
+            // Merge runs [k, Mid) and [Mid, End)
+            Mid = k + Width;  if (Mid > n) Mid = n;
+            End = k + 2 * Width;  if (End > n) End = n;
+            i = k;  j = Mid;  d = k;
+            while (i < Mid && j < End) {
+                // Take from the second run only if strictly smaller
+                if (strcmp(Strings + Source[j].String, Strings + Source[i].String) < 0) {
+                    Dest[d++] = Source[j++];
+                }
+                else {
+                    Dest[d++] = Source[i++];
+                }
             }
+            while (i < Mid) Dest[d++] = Source[i++];
+            while (j < End) Dest[d++] = Source[j++];
         }
+        Swap = Source;  Source = Dest;  Dest = Swap;
+    }
+    if (Source != Table) {
+        // Result is in TempTable
+        memcpy(Table, Source, n * sizeof(SStringEntry));
     }
     // Now StringEntries has been sorted. Reorder StringBuffer to the sort order.
     CMemoryBuffer SortedStringBuffer;    // Temporary buffer for strings in sort order
@@ -1666,7 +1873,7 @@ void CLibrary::MakeSymbolTableUnix() {
     // older than the .a file. Fix this by post-dating the symbol table:
     uint32_t PostDate = 0;
     if (SymbolTableType & 0x10000000) PostDate = 100; // Post-date if mac sorted symbol table
-    sprintf(SymTab.Date, "%u ", (uint32_t)time(0) + PostDate); // Date stamp for symbol table
+    sprintf(SymTab.Date, "%u ", cmd.TimeStamp() + PostDate); // Date stamp for symbol table
 
     SymTab.UserID[0] = '0';                // UserID = 0  (may be omitted in COFF)
     SymTab.GroupID[0] = '0';               // GroupID = 0 (may be omitted in COFF)
@@ -1676,7 +1883,12 @@ void CLibrary::MakeSymbolTableUnix() {
     SymTab.HeaderEnd[1] = '\n';
 
     // File header
-    OutFile.Push("!<arch>\n", 8);
+    if (cmd.LibrarySubtype == LIBTYPE_THIN) {
+        OutFile.Push("!<thin>\n", 8);
+    }
+    else {
+        OutFile.Push("!<arch>\n", 8);
+    }
 
     uint32_t NumMembers = Indexes.GetNumEntries();        // Number of members
     uint32_t NumStrings = StringEntries.GetNumEntries();  // Number of symbol names
@@ -1885,6 +2097,43 @@ void CLibrary::MakeSymbolTableUnix() {
 }
 
 
+char const * CLibrary::ThinMemberPath(char const * File) {
+    // Make path of object file relative to the directory of the thin output archive.
+    // A path relative to the current directory is converted by removing the archive
+    // directory if it is a prefix, or else going one level up for each directory in it
+    char const * Archive = OutputFileName ? OutputFileName : cmd.InputFile;
+    uint32_t DirLength = 0;                       // Length of directory part of archive path
+    uint32_t i, j;                                // Loop counters
+
+    if (File[0] == '/' || File[0] == '\\' || (File[0] && File[1] == ':')) {
+        return File;                               // Absolute path
+    }
+    for (i = 0; Archive[i]; i++) {
+        if (Archive[i] == '/' || Archive[i] == '\\') DirLength = i + 1;
+    }
+    if (DirLength == 0) return File;               // Archive is in current directory
+    if (strncmp(File, Archive, DirLength) == 0) {
+        return File + DirLength;                   // Object file is in archive directory or below
+    }
+    if (Archive[0] == '/' || Archive[0] == '\\' || Archive[1] == ':') {
+        err.submit(2510, File);  return File;      // Cannot relate relative path to absolute path
+    }
+    // Go one level up for each directory in archive path
+    ThinOutPath.SetSize(0);
+    for (i = 0; i < DirLength; i = j + 1) {
+        // Find end of this directory name
+        for (j = i; Archive[j] != '/' && Archive[j] != '\\'; j++);
+        if (j == i || (j == i + 1 && Archive[i] == '.')) continue; // Empty or "."
+        if (j == i + 2 && Archive[i] == '.' && Archive[i+1] == '.') {
+            err.submit(2510, File);  return File;  // ".." in archive path not supported
+        }
+        ThinOutPath.Push("../", 3);
+    }
+    ThinOutPath.PushString(File);
+    return (char const*)ThinOutPath.Buf();
+}
+
+
 void CLibrary::MakeBinaryFile() {
     if (cmd.OutputType == FILETYPE_OMF) {
         MakeBinaryFileOMF();                       // OMF style output library
@@ -2016,16 +2265,56 @@ void CLibrary::MakeBinaryFileUNIX() {
 
 
 void CLibrary::CheckOMFHash(CMemoryBuffer &stringbuf, CSList<SStringEntry> &index) {
-    // Check if OMF library hash table has correct entries for all symbol names
+    // Check if OMF library hash table has correct entries for all symbol names,
+    // and print statistics for block fill levels and search lengths
     uint32_t i;                                     // Loop counter
     char * Name;                                    // Public symbol name
     COMFHashTable HashTab;                          // OMF hash table interpreter
     uint32_t NString;                               // Number of occurrences of Name in hash table
     uint32_t Module;                                // Module with first occurrence of Name
     uint32_t Conf, ConfSum = 0;                     // Count number of conflicting entries in hash table
+    uint32_t Found = 0;                             // Number of names found
+    uint32_t ProbeSum = 0, ProbeMax = 0;            // Number of buckets examined to find each name
+    char * ProbeMaxName = 0;                        // Name with longest search
+    uint32_t ProbeHistogram[5] = {0};               // Count names found with 1, 2, 3, 4-8, > 8 buckets examined
+    uint32_t Block, Bucket;                         // Block and bucket index
+    uint32_t StringIndex;                           // Index to string in block
+    uint32_t BucketsUsed;                           // Number of used buckets in block
+    uint32_t BucketsMin = OMFNumBuckets, BucketsMax = 0; // Minimum and maximum buckets used per block
+    uint32_t Entries = 0;                           // Number of strings in dictionary
+    uint32_t FullBlocks = 0;                        // Number of blocks marked as full
+    uint32_t SpaceUsed = 0;                         // String space used in all blocks
+    uint32_t FillHistogram[4] = {0};                // Count blocks with 0-9, 10-19, 20-29, 30-37 buckets used
+
+    if ((uint64_t)DictionaryOffset + (uint64_t)DictionarySize * OMFBlockSize > GetDataSize()) {
+        return;                                     // File is truncated. Error reported by caller
+    }
+    SOMFHashBlock * Blocks = &Get<SOMFHashBlock>(DictionaryOffset);
+
+    // Scan the dictionary blocks
+    for (Block = 0; Block < DictionarySize; Block++) {
+        BucketsUsed = 0;
+        for (Bucket = 0; Bucket < OMFNumBuckets; Bucket++) {
+            StringIndex = Blocks[Block].b.Buckets[Bucket];
+            if (StringIndex == 0) continue;
+            // Check that string and module number are inside block
+            if (StringIndex * 2 < OMFNumBuckets + 1
+            || StringIndex * 2 + Blocks[Block].Strings[StringIndex * 2] + 3 > OMFBlockSize) {
+                err.submit(2604, Block);  break;
+            }
+            BucketsUsed++;
+            SpaceUsed += (Blocks[Block].Strings[StringIndex * 2] + 4) & -2;
+        }
+        Entries += BucketsUsed;
+        if (BucketsUsed < BucketsMin) BucketsMin = BucketsUsed;
+        if (BucketsUsed > BucketsMax) BucketsMax = BucketsUsed;
+        FillHistogram[BucketsUsed < 30 ? BucketsUsed / 10 : 3]++;
+        if (Blocks[Block].b.FreeSpace == 0xFF) FullBlocks++;
+    }
+    if (err.Number()) return;
 
     // Initialize hash table interpreter
-    HashTab.Init(&Get<SOMFHashBlock>(DictionaryOffset), DictionarySize);
+    HashTab.Init(Blocks, DictionarySize);
 
     // Loop through public symbol names
     for (i = 0; i < index.GetNumEntries(); i++) {
@@ -2042,10 +2331,310 @@ void CLibrary::CheckOMFHash(CMemoryBuffer &stringbuf, CSList<SStringEntry> &inde
         if (NString == 0) err.submit(2603, Name);  // Error if not found
         if (NString >  1) err.submit(1213, NString, Name);  // Warning more than one occurrence
 
+        // Statistics for search length
+        if (NString) {
+            Found++;
+            ProbeSum += HashTab.Probes;
+            if (HashTab.Probes > ProbeMax) {
+                ProbeMax = HashTab.Probes;  ProbeMaxName = Name;
+            }
+            ProbeHistogram[HashTab.Probes <= 3 ? HashTab.Probes - 1 : (HashTab.Probes <= 8 ? 3 : 4)]++;
+        }
         //printf("\n%i occurence of %s, module offset %i", NString, Name, Module);
     }
     printf("\n\nHash table %i blocks x 37 buckets at offet 0x%X.\n Efficiency: %i conflicts for %i entries",
         DictionarySize, DictionaryOffset, ConfSum, index.GetNumEntries());
+
+    // Print block statistics
+    if (DictionarySize == 0) return;
+    printf("\n Dictionary has %i names. %i blocks full. String space used %i%%.",
+        Entries, FullBlocks, SpaceUsed * 100 / (DictionarySize * (OMFBlockSize - OMFNumBuckets - 1)));
+    printf("\n Buckets used per block: min %i, average %.1f, max %i. Blocks with 0-9: %i, 10-19: %i, 20-29: %i, 30-37: %i",
+        BucketsMin, (double)Entries / DictionarySize, BucketsMax,
+        FillHistogram[0], FillHistogram[1], FillHistogram[2], FillHistogram[3]);
+    // Print search length statistics
+    if (Found) {
+        printf("\n Buckets examined per name: average %.2f, max %i (%s)",
+            (double)ProbeSum / Found, ProbeMax, ProbeMaxName);
+        printf("\n Names found after 1: %i, 2: %i, 3: %i, 4-8: %i, more: %i buckets",
+            ProbeHistogram[0], ProbeHistogram[1], ProbeHistogram[2], ProbeHistogram[3], ProbeHistogram[4]);
+    }
+}
+
+
+void CLibrary::FindSymbols() {
+    // Find members defining symbols specified with -lf option.
+    // Only the symbol index of the library is read, not the members
+
+    printf("\nSymbol search in library %s:", cmd.InputFile);
+
+    // Dispatch according to library type
+    switch (cmd.InputType) {
+    case FILETYPE_LIBRARY:
+        FindSymbolsUNIX();  break;                 // Search symbol index of UNIX style library
+
+    case FILETYPE_OMFLIBRARY:
+        FindSymbolsOMF();   break;                 // Search hash table of OMF style library
+
+    default:
+        err.submit(9000);                          // Should not occur
+    }
+}
+
+void CLibrary::FindSymbolsUNIX() {
+    // Search symbol index of UNIX style library.
+    // Only the headers of the index members and the longnames member are read.
+    // The index may be a System V/GNU/COFF first linker member "/" (big endian),
+    // a COFF second linker member "/" (little endian, sorted), a GNU 64-bit
+    // linker member "/SYM64/", or a BSD/Mac "__.SYMDEF"
+    SUNIXLibraryHeader * Header;                  // Member header
+    char * Name;                                  // Name of member
+    char * Strings;                               // String table of symbol index
+    uint32_t StringsSize;                         // Size of string table
+    uint32_t DataOffset;                          // Offset to member data
+    uint32_t MemberSize;                          // Size of member
+    uint32_t Index1 = 0, Index1Size = 0;          // First linker member, big endian
+    uint32_t Index2 = 0, Index2Size = 0;          // COFF second linker member, sorted
+    uint32_t Index64 = 0, Index64Size = 0;        // 64-bit linker member "/SYM64/", big endian
+    uint32_t Symdef = 0, SymdefSize = 0;          // BSD/Mac symbol table
+    uint32_t NumSymbols;                          // Number of symbols in index
+    uint32_t NumMembers;                          // Number of members in COFF second linker member
+    uint32_t i;                                   // Loop counter
+    SLibraryNameQuery Query;                      // Symbol to find
+    SSymbolChange const * sym;                    // Symbol name from command line
+
+    // Make sorted list of symbol names to find
+    while ((sym = cmd.GetLibraryRequest(SYMA_FIND_SYMBOL)) != 0) {
+        Query.Name = sym->Name1;
+        Query.Member = Query.Count = 0;
+        NameQueries.PushUnique(Query);
+    }
+    if (NameQueries.GetNumEntries() == 0) return;
+
+    // Scan the headers of the special members in the beginning of the library
+    LongNames = LongNamesSize = 0;
+    CurrentOffset = 8;
+    while (CurrentOffset) {
+        Header = &Get<SUNIXLibraryHeader>(CurrentOffset);
+        Name = Header->Name;
+        DataOffset = CurrentOffset + sizeof(SUNIXLibraryHeader);
+        MemberSize = (uint32_t)atoi(Header->FileSize);
+        if (strncmp(Name, "// ", 3) == 0) {
+            // Long names member
+            LongNames = DataOffset;  LongNamesSize = MemberSize;
+        }
+        else if (strncmp(Name, "/ ", 2) == 0) {
+            // Linker member. The second one, if any, is the COFF sorted index
+            if (Index1 == 0) {
+                Index1 = DataOffset;  Index1Size = MemberSize;
+            }
+            else {
+                Index2 = DataOffset;  Index2Size = MemberSize;
+            }
+        }
+        else if (strncmp(Name, "/SYM64/", 7) == 0) {
+            // 64-bit linker member
+            Index64 = DataOffset;  Index64Size = MemberSize;
+        }
+        else if (strncmp(Name, "__.SYMDEF", 9) == 0) {
+            // BSD symbol table with short name
+            Symdef = DataOffset;  SymdefSize = MemberSize;
+        }
+        else if (strncmp(Name, "#1/", 3) == 0 && strncmp(Name + sizeof(SUNIXLibraryHeader), "__.SYMDEF", 9) == 0) {
+            // BSD symbol table with long name stored after the header
+            i = atoi(Name + 3);
+            if (i > MemberSize) {err.submit(2500); return;}
+            Symdef = DataOffset + i;  SymdefSize = MemberSize - i;
+        }
+        else break;                                // First ordinary member. No more index members
+        CurrentOffset = NextHeader(CurrentOffset);
+    }
+    if (err.Number()) return;
+
+    if (Index2) {
+        // COFF second linker member:
+        // NumMembers, member offsets, NumSymbols, 16-bit member indexes, sorted strings
+        if (Index2Size < 8) {err.submit(2500); return;}
+        NumMembers = Get<uint32_t>(Index2);
+        if (((uint64_t)NumMembers + 2) * 4 > Index2Size) {err.submit(2500); return;}
+        NumSymbols = Get<uint32_t>(Index2 + 4 + NumMembers * 4);
+        if (((uint64_t)NumMembers + 2) * 4 + (uint64_t)NumSymbols * 2 > Index2Size) {err.submit(2500); return;}
+        uint16_t * MemberIndexes = &Get<uint16_t>(Index2 + 8 + NumMembers * 4);
+        Strings = (char*)Buf() + Index2 + 8 + NumMembers * 4 + NumSymbols * 2;
+        StringsSize = Index2Size - (8 + NumMembers * 4 + NumSymbols * 2);
+        // Last name to find. The strings are sorted so we can stop after this
+        char const * LastQuery = NameQueries[NameQueries.GetNumEntries()-1].Name;
+        for (i = 0; i < NumSymbols; i++) {
+            char * End = (char*)memchr(Strings, 0, StringsSize);
+            if (End == 0) {err.submit(2500); return;}
+            if (strcmp(Strings, LastQuery) > 0) break;
+            uint32_t MemberI = MemberIndexes[i] - 1u;
+            if (MemberI < NumMembers) {
+                MatchSymbolUNIX(Strings, Get<uint32_t>(Index2 + 4 + MemberI * 4));
+            }
+            StringsSize -= uint32_t(End + 1 - Strings);
+            Strings = End + 1;
+        }
+    }
+    else if (Index1) {
+        // System V/GNU or COFF first linker member:
+        // NumSymbols, member offsets, strings. Numbers are big endian
+        if (Index1Size < 4) {err.submit(2500); return;}
+        NumSymbols = EndianChange(Get<uint32_t>(Index1));
+        if (((uint64_t)NumSymbols + 1) * 4 > Index1Size) {err.submit(2500); return;}
+        Strings = (char*)Buf() + Index1 + (NumSymbols + 1) * 4;
+        StringsSize = Index1Size - (NumSymbols + 1) * 4;
+        for (i = 0; i < NumSymbols; i++) {
+            char * End = (char*)memchr(Strings, 0, StringsSize);
+            if (End == 0) {err.submit(2500); return;}
+            MatchSymbolUNIX(Strings, EndianChange(Get<uint32_t>(Index1 + 4 + i * 4)));
+            StringsSize -= uint32_t(End + 1 - Strings);
+            Strings = End + 1;
+        }
+    }
+    else if (Index64) {
+        // 64-bit linker member: NumSymbols, member offsets, strings.
+        // Numbers are 64-bit big endian. Offsets above 4 GB cannot occur in this buffer
+        if (Index64Size < 8) {err.submit(2500); return;}
+        if (Get<uint32_t>(Index64)) {err.submit(2500); return;}
+        NumSymbols = EndianChange(Get<uint32_t>(Index64 + 4));
+        if (((uint64_t)NumSymbols + 1) * 8 > Index64Size) {err.submit(2500); return;}
+        Strings = (char*)Buf() + Index64 + (NumSymbols + 1) * 8;
+        StringsSize = Index64Size - (NumSymbols + 1) * 8;
+        for (i = 0; i < NumSymbols; i++) {
+            char * End = (char*)memchr(Strings, 0, StringsSize);
+            if (End == 0) {err.submit(2500); return;}
+            uint32_t OffsetHigh = Get<uint32_t>(Index64 + 8 + i * 8);
+            MatchSymbolUNIX(Strings, OffsetHigh ? 0xFFFFFFFF : EndianChange(Get<uint32_t>(Index64 + 12 + i * 8)));
+            StringsSize -= uint32_t(End + 1 - Strings);
+            Strings = End + 1;
+        }
+    }
+    else if (Symdef) {
+        // BSD/Mac symbol table:
+        // Size of array, array of (string offset, member offset), size of strings, strings
+        if (SymdefSize < 8) {err.submit(2500); return;}
+        uint32_t ArraySize = Get<uint32_t>(Symdef);
+        if ((uint64_t)ArraySize + 8 > SymdefSize) {err.submit(2500); return;}
+        StringsSize = Get<uint32_t>(Symdef + 4 + ArraySize);
+        if ((uint64_t)ArraySize + 8 + StringsSize > SymdefSize) {err.submit(2500); return;}
+        Strings = (char*)Buf() + Symdef + 8 + ArraySize;
+        NumSymbols = ArraySize / sizeof(SStringEntry);
+        for (i = 0; i < NumSymbols; i++) {
+            SStringEntry & Entry = Get<SStringEntry>(Symdef + 4 + i * sizeof(SStringEntry));
+            if (Entry.String >= StringsSize || memchr(Strings + Entry.String, 0, StringsSize - Entry.String) == 0) {
+                err.submit(2500); return;
+            }
+            MatchSymbolUNIX(Strings + Entry.String, Entry.Member);
+        }
+    }
+    else {
+        // No symbol index
+        err.submit(2508);  return;
+    }
+
+    // Print results in the order of the command line
+    while ((sym = cmd.GetLibraryRequest(SYMA_FIND_SYMBOL)) != 0) {
+        Query.Name = sym->Name1;
+        int32_t q = NameQueries.Exists(Query);
+        if (q < 0) continue;
+        SLibraryNameQuery & Found = NameQueries[q];
+        if (Found.Count == 0) {
+            printf("\n  %s: not found", Found.Name);
+        }
+        else {
+            printf("\n  %s: %s", Found.Name, GetMemberNameUNIX(Found.Member));
+            if (Found.Count > 1) printf(" (%i definitions)", Found.Count);
+        }
+    }
+}
+
+void CLibrary::MatchSymbolUNIX(char const * Name, uint32_t Member) {
+    // Check if symbol index entry is one of the symbols to find
+    SLibraryNameQuery Query;
+    Query.Name = Name;
+    int32_t q = NameQueries.Exists(Query);
+    if (q < 0) return;                            // Not searched for
+    if (NameQueries[q].Count++ == 0) {
+        NameQueries[q].Member = Member;          // Remember first member defining symbol
+    }
+}
+
+const char * CLibrary::GetMemberNameUNIX(uint32_t Offset) {
+    // Get name of UNIX library member from header offset.
+    // The input file is not modified
+    static char name[MAXSYMBOLLENGTH];
+    char const * p;                               // Pointer to name
+    uint32_t len;                                 // Max length of name
+    uint32_t i;                                   // Loop counter
+    int LongName = 0;                             // Name is in longnames member
+
+    if ((uint64_t)Offset + sizeof(SUNIXLibraryHeader) > DataSize) return "?";
+    p = (char*)Buf() + Offset;
+    len = 16;
+    if (strncmp(p, "#1/", 3) == 0) {
+        // Long name after header
+        len = atoi(p + 3);
+        p += sizeof(SUNIXLibraryHeader);
+        if ((uint64_t)Offset + sizeof(SUNIXLibraryHeader) + len > DataSize) return "?";
+        LongName = 1;
+    }
+    else if (p[0] == '/' && p[1] >= '0' && p[1] <= '9') {
+        // Index into longnames member
+        uint32_t NameIndex = atoi(p + 1);
+        if (LongNames == 0 || NameIndex >= LongNamesSize) return "?";
+        p = (char*)Buf() + LongNames + NameIndex;
+        len = LongNamesSize - NameIndex;
+        LongName = 1;
+    }
+    if (len >= MAXSYMBOLLENGTH) len = MAXSYMBOLLENGTH - 1;
+    // Copy name. Short names end with '/' or space, long names with 0, "/\n" or "\n"
+    for (i = 0; i < len; i++) {
+        char c = p[i];
+        if (c == 0 || c == '\n') break;
+        if (c == '/' && (!LongName || p[i+1] == '\n' || p[i+1] == 0)) break;
+        if (c == ' ' && !LongName) break;
+        name[i] = c;
+    }
+    name[i] = 0;
+    return name;
+}
+
+void CLibrary::FindSymbolsOMF() {
+    // Search hash table of OMF style library
+    SSymbolChange const * sym;                    // Symbol name from command line
+    COMFHashTable HashTab;                        // OMF hash table interpreter
+    uint32_t NString;                             // Number of occurrences of name in hash table
+    uint32_t ModulePage = 0;                      // Page of module with first occurrence
+    uint32_t Conf;                                // Number of conflicting entries
+    SOMFRecordPointer rec;                        // Record pointer for reading THEADR
+
+    // Read library header
+    StartExtracting();
+    if (err.Number()) return;
+    if (DictionarySize == 0) {err.submit(2508); return;}
+    if ((uint64_t)DictionaryOffset + (uint64_t)DictionarySize * OMFBlockSize > GetDataSize()) {
+        err.submit(2500); return;                  // File is truncated
+    }
+    // Initialize hash table interpreter
+    HashTab.Init(&Get<SOMFHashBlock>(DictionaryOffset), DictionarySize);
+
+    while ((sym = cmd.GetLibraryRequest(SYMA_FIND_SYMBOL)) != 0) {
+        HashTab.MakeHash(sym->Name1);
+        NString = HashTab.FindString(ModulePage, Conf);
+        if (NString == 0) {
+            printf("\n  %s: not found", sym->Name1);
+            continue;
+        }
+        // Get module name from THEADR record
+        const char * ModuleName = "?";
+        if ((uint64_t)ModulePage * PageSize < DictionaryOffset) {
+            rec.Start(Buf(), ModulePage * PageSize, DictionaryOffset);
+            if (rec.Type2 == OMF_THEADR) ModuleName = rec.GetString();
+        }
+        printf("\n  %s: %s", sym->Name1, ModuleName);
+        if (NString > 1) printf(" (%i definitions)", NString);
+    }
 }
 
 
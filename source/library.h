@@ -31,6 +31,18 @@ struct SUNIXLibraryHeader {
 };
 
 
+// Name to search for in a UNIX style library: symbol name in the symbol index (-lf option)
+// or name of member to extract (-lx option)
+struct SLibraryNameQuery {
+    char const * Name;                  // Symbol name or member name
+    uint32_t Member;                    // Offset to header of member found, 0 if not found
+    uint32_t Count;                     // Number of matches found
+    int operator < (SLibraryNameQuery const & y) const { // Operator for sorting by name
+        return strcmp(Name, y.Name) < 0;
+    }
+};
+
+
 // Class for extracting members from library or building a library
 class CLibrary : public CFileBuffer {
 public:
@@ -56,14 +68,27 @@ protected:
     void DumpUNIX();                    // Print contents of UNIX style library
     void DumpOMF();                     // Print contents of OMF style library
     void CheckOMFHash(CMemoryBuffer &stringbuf, CSList<SStringEntry> &index);// Check if OMF library hash table has correct entries for all symbol names
+    void FindSymbols();                 // Find members defining symbols specified with -lf option
+    void FindSymbolsUNIX();             // Search symbol index of UNIX style library
+    void FindSymbolsOMF();              // Search hash table of OMF style library
+    void MatchSymbolUNIX(char const * Name, uint32_t Member); // Check if symbol index entry is one of the symbols to find
+    const char * GetMemberNameUNIX(uint32_t Offset); // Get name of UNIX library member from header offset
+    CSList<SLibraryNameQuery> NameQueries; // Symbols to find or members to extract, sorted by name
     void StartExtracting();             // Initialize before ExtractMember()
     char * ExtractMember(CFileBuffer*); // Extract next library member from input library
     char * ExtractMemberUNIX(CFileBuffer*); // Extract member of UNIX style library
     char * ExtractMemberOMF(CFileBuffer*);  // Extract member of OMF style library
     uint32_t NextHeader(uint32_t Offset);   // Loop through library headers
+    int  IsThinArchive();               // Check if input is a GNU thin archive
+    int  MemberIsExternal(SUNIXLibraryHeader * Header); // Check if member data is in a separate file (thin archive)
+    CMemoryBuffer ThinPath;             // Path of object file of current member of thin input archive
+    CMemoryBuffer ThinNames;            // Copy of longnames member of thin input archive, before member names are modified
+    void ExtractSelectedMembers();      // Extract members specified by name from UNIX style library
+    int  ExtractMemberToFile(char const * MemberName1, char const * MemberName2); // Write or dump member in MemberBuffer
     CConverter MemberBuffer;            // Buffer containing single library member
     uint32_t CurrentOffset;               // Offset to current member
     uint32_t CurrentNumber;               // Number of current member
+    uint32_t MemberHeader;                // Offset to header of last member extracted from UNIX style library
     int  MemberFileType;                // File type of members
     // Methods and properties for modifying or writing library
     void FixNames();                    // Calls StripMemberNamesUNIX or RebuildOMF
@@ -77,6 +102,9 @@ protected:
     void MakeBinaryFileOMF();           // Make OMF library
     void SortStringTable();             // Sort the string table
     void MakeSymbolTableUnix();         // Make symbol table for COFF, ELF or MACHO library
+    char const * ThinMemberPath(char const * File); // Make path of object file relative to thin output archive
+    char const * MemberPath;            // Path of object file for current member, used in thin archive output
+    CMemoryBuffer ThinOutPath;          // Buffer for path made by ThinMemberPath
     CFileBuffer OutFile;                // Buffer for building output file
     CSList<SStringEntry> StringEntries; // String table using SStringEntry
     CMemoryBuffer LongNamesBuffer;      // Buffer for building the "//" longnames member
@@ -104,14 +132,27 @@ union SOMFHashBlock {
 };
 
 
+// Hash values for one string, independent of the number of blocks
+struct SOMFHashValues {
+    char * String;                        // Symbol name
+    uint32_t StringLength;                // Length of name
+    uint16_t BlockX;                      // Start block before modulo number of blocks
+    uint16_t BlockD;                      // Block step size before modulo number of blocks
+    uint16_t StartBucket;                 // Start bucket
+    uint16_t BucketD;                     // Bucket step size
+};
+
 // Hash table handler
 class COMFHashTable {
 public:
     void Init(SOMFHashBlock * blocks, uint32_t NumBlocks); // Initialize
     void MakeHash(char * name);         // Compute hash
+    void ComputeHash(char * name, SOMFHashValues & Values); // Compute hash values that do not depend on NumBlocks
+    void SetHash(SOMFHashValues const & Values); // Set search position from hash values
     int  FindString(uint32_t & ModulePage, uint32_t & Conflicts); // Search for string. Get number of occurrences, module, number of conflicting strings
     int  InsertString(uint16_t & ModulePage); // Insert string in hash table. Return 0 if success
     void MakeHashTable(CSList<SStringEntry> & StringEntries, CMemoryBuffer & StringBuffer, CMemoryBuffer & HashTable, CLibrary * Library); // Make hash table
+    uint32_t Probes;                      // Number of buckets examined by FindString before first match
 protected:
     char * String;                        // String to search for or insert
     uint32_t StringLength;                // Length of string
@@ -47,6 +47,11 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::Convert() {
    ToFile.SetFileType(FILETYPE_ELF);       // Set type of to file
    MakeSegments();                         // Make segment headers and code/data segments
    MakeSymbolTable();                      // Symbol table and string tables
+   if (HasGOT) {
+      // Index from new symbol to fake GOT entry
+      GOTIndex.SetNum(NewSections[symtab].GetDataSize() / sizeof(TELF_Symbol));
+      GOTIndex.SetZero();
+   }
    MakeRelocationTables(this->FileHeader); // Make relocation tables
    MakeImportTables();                     // Fill import tables
    MakeGOT();                              // Make fake Global Offset Table
@@ -82,6 +87,7 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeSegments() {
    const uint32_t NumSpecialSegments = sizeof(SpecialSegmentNames)/sizeof(SpecialSegmentNames[0]);
 
    // Make first section header string table entry empty
+   NewSections[shstrtab].SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of names
    NewSections[shstrtab].PushString("");
 
    // Loop through special sections, except the first Null section:
@@ -243,7 +249,25 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeSegments() {
                NewSecHeader.sh_flags = SHF_WRITE | SHF_ALLOC;
             }
 
-            // Put name into section header string table
+            // Check if section is import table
+            int SectionType   = sectp->flags & MAC_SECTION_TYPE;
+            int IsImportTable = SectionType >= MAC_S_NON_LAZY_SYMBOL_POINTERS && SectionType <= MAC_S_SYMBOL_STUBS;
+
+            // Name for relocation section = ".rel" or ".rela" + name of section
+            if (WordSize == 32) {
+               strcpy(RelocationSectionName, ".rel");
+            }
+            else {
+               strcpy(RelocationSectionName, ".rela");
+            }
+            strncat(RelocationSectionName, SecName, MAXSECTIONNAMELENGTH-5);
+            RelocationSectionName[MAXSECTIONNAMELENGTH-1] = 0;
+
+            // Put name into section header string table. With option -sm the longer 
+            // relocation section name is stored first so that the section name can share its tail
+            if (cmd.SuffixMerge && (sectp->nreloc > 0 || IsImportTable)) {
+               NewSections[shstrtab].PushString(RelocationSectionName);
+            }
             SecNameIndex = NewSections[shstrtab].PushString(SecName);
 
             // Put name into new section header
@@ -264,10 +288,6 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeSegments() {
             // Increment section number
             newsec++;
 
-            // Check if section is import table
-            int SectionType   = sectp->flags & MAC_SECTION_TYPE;
-            int IsImportTable = SectionType >= MAC_S_NON_LAZY_SYMBOL_POINTERS && SectionType <= MAC_S_SYMBOL_STUBS;
-
             if (sectp->nreloc > 0 || IsImportTable) {
                // Source section has relocations. 
                // Make a relocation section in destination file
@@ -276,16 +296,6 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeSegments() {
                // Initialize to zero
                memset(&NewSecHeader, 0, sizeof(NewSecHeader));
 
-               // Name for relocation section = ".rel" or ".rela" + name of section
-               if (WordSize == 32) {
-                  strcpy(RelocationSectionName, ".rel");
-               }
-               else {
-                  strcpy(RelocationSectionName, ".rela");
-               }
-               strncat(RelocationSectionName, SecName, MAXSECTIONNAMELENGTH-5);
-               RelocationSectionName[MAXSECTIONNAMELENGTH-1] = 0;
-
                // Put name into section header string table
                uint32_t SecNameIndex = NewSections[shstrtab].PushString(RelocationSectionName);
 
@@ -389,6 +399,7 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeSymbolTable() {
    NewSections[symtab].Push(0, sizeof(TELF_Symbol));
 
    // Make first string table entries empty
+   NewSections[strtab] .SetSuffixMerge(cmd.SuffixMerge);
    NewSections[strtab] .PushString("");
    NewSections[stabstr].PushString("");
 
@@ -588,9 +599,15 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeRelocationTables(MAC_header_32&)
             NewRelTableSecHeader->sh_entsize = sizeof(Elf32_Rel); // Entry size:
 
             // Pointer to old relocation entry
-            if (sectp->reloff >= this->GetDataSize()) {err.submit(2035); break;}
+            if (sectp->reloff >= this->GetDataSize() 
+            || uint64_t(sectp->reloff) + uint64_t(sectp->nreloc) * sizeof(MAC_relocation_info) > this->GetDataSize()) {
+               err.submit(2035); break;
+            }
             MAC_relocation_info * relp = (MAC_relocation_info*)(this->Buf() + sectp->reloff);
 
+            // Allocate space for all relocations of this section at once
+            NewSections[newsecr].SetSize(NewSections[newsecr].GetDataSize() + sectp->nreloc * sizeof(Elf32_Rel));
+
             // Loop through old relocations
             for (uint32_t oldr = 1; oldr <= sectp->nreloc; oldr++, relp++) {
 
@@ -844,9 +861,15 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeRelocationTables(MAC_header_64&)
             NewRelTableSecHeader->sh_entsize = sizeof(Elf64_Rela);
 
             // Pointer to old relocation entry
-            if (sectp->reloff >= this->GetDataSize()) {err.submit(2035); break;}
+            if (sectp->reloff >= this->GetDataSize() 
+            || uint64_t(sectp->reloff) + uint64_t(sectp->nreloc) * sizeof(MAC_relocation_info) > this->GetDataSize()) {
+               err.submit(2035); break;
+            }
             MAC_relocation_info * relp = (MAC_relocation_info*)(this->Buf() + sectp->reloff);
 
+            // Allocate space for all relocations of this section at once
+            NewSections[newsecr].SetSize(NewSections[newsecr].GetDataSize() + sectp->nreloc * sizeof(Elf64_Rela));
+
             // Loop through old relocations
             for (uint32_t oldr = 1; oldr <= sectp->nreloc; oldr++, relp++) {
 
@@ -978,6 +1001,23 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeRelocationTables(MAC_header_64&)
                      NewRelocEntry.r_type = R_X86_64_PC32;
                      break;
                   }
+
+                  // The x86-64 linker ignores the inline field of a relocation with 
+                  // explicit addend (SHT_RELA). Move the inline addend into r_addend
+                  if (NewRelocEntry.r_type == R_X86_64_64) {
+                     if (NewRelocEntry.r_offset + 8 > NewSections[newsec].GetDataSize()) {
+                        err.submit(2035); continue; // Out of range
+                     }
+                     NewRelocEntry.r_addend = *(int64_t*)inlinep;
+                     *(int64_t*)inlinep = 0;
+                  }
+                  else {
+                     if (NewRelocEntry.r_offset + 4 > NewSections[newsec].GetDataSize()) {
+                        err.submit(2035); continue; // Out of range
+                     }
+                     NewRelocEntry.r_addend = *inlinep;
+                     *inlinep = 0;
+                  }
                }
 
                // Put relocation record into table
@@ -1173,6 +1213,7 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeImportTables() {
                }
                else if (EntrySize == 5) {
                   NewRelocEntry.r_type = R_X86_64_PC32;
+                  NewRelocEntry.r_addend = -4;    // Explicit addend. Inline field is ignored
                }
                else {
                   err.submit(2045);
@@ -1189,6 +1230,8 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeImportTables() {
                   err.submit(9000); // Outside section
                }
                memcpy(NewSections[NewSec1].Buf()+Offset-1, JmpInstruction, 5);
+               // 64 bit: addend is in relocation record (SHT_RELA)
+               if (WordSize == 64) memset(NewSections[NewSec1].Buf()+Offset, 0, 4);
             }
          }
       }
@@ -1220,22 +1263,21 @@ template <class TMAC_header, class TMAC_segment_command, class TMAC_section, cla
           class TELF_Header, class TELF_SectionHeader, class TELF_Symbol, class TELF_Relocation>
 uint32_t CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeGOTEntry(int symbol) {
    // Make entry in fake GOT for symbol
-   uint32_t NumGOTEntries = GOTSymbols.GetNumEntries();
-   uint32_t symi;  // Symbol index
    const int WordSize = sizeof(MInt) * 8;
 
    // Get symbol for start of GOT
    FakeGOTSymbol = SectionSymbols[FakeGOTSection];
-   
-   // Search for symbol in previous entries
-   for (symi = 0; symi < NumGOTEntries; symi++) {
-      if (GOTSymbols[symi] == symbol) break;
+
+   if ((uint32_t)symbol >= GOTIndex.GetNumEntries()) {
+      err.submit(2031);  return 0;             // Symbol index out of range
    }
-   if (symi == NumGOTEntries) {
+   // Look up symbol in previous entries
+   if (GOTIndex[symbol] == 0) {
       // Not found. Make new entry
       GOTSymbols.Push(symbol);
+      GOTIndex[symbol] = GOTSymbols.GetNumEntries();
    }
-   return symi * (WordSize / 8);
+   return (GOTIndex[symbol] - 1) * (WordSize / 8);
 }
 
 
@@ -1248,6 +1290,7 @@ void CMAC2ELF<MACSTRUCTURES,ELFSTRUCTURES>::MakeGOT() {
 
    uint32_t NumEntries = GOTSymbols.GetNumEntries();
    NewSections[FakeGOTSection].Push(0, NumEntries*(WordSize/8)); 
+   NewSections[FakeGOTSection+1].SetSize(NumEntries*sizeof(Elf64_Rela));
 
    // Make relocations for GOT
    Elf64_Rela NewRelocEntry;
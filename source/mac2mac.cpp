@@ -136,6 +136,7 @@ void CMAC2MAC<MACSTRUCTURES>::MakeSymbolTable() {
    }
 
    // Put everything into symbol table and string table
+   NewStringTable.SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of names
    for (NewScope = 0; NewScope < 3; NewScope++) {
       NewSymbols[NewScope].SortList();  // Sort each list alphabetically
       NewSymbols[NewScope].StoreList(&NewSymbolTable, &NewStringTable);
@@ -205,8 +206,24 @@ void CMAC2MAC<MACSTRUCTURES>::MakeBinaryFile() {
    if (this->StringTabOffset && this->StringTabOffset < NewSymtabOffset) NewSymtabOffset = this->StringTabOffset;
    if (NewSymtabOffset == 0) NewSymtabOffset = this->GetDataSize();
 
-   // Copy all headers and all data until TablesOffset
-   ToFile.Push(this->Buf(), NewSymtabOffset);
+   // Find end of old tables
+   OldSymtabEnd = this->SymTabOffset + this->SymTabNumber * sizeof(TMAC_nlist);
+   OldStringtabEnd = this->StringTabOffset + this->StringTabSize;
+   OldTablesEnd = OldStringtabEnd;
+   if (OldSymtabEnd > OldTablesEnd) OldTablesEnd = OldSymtabEnd;
+   if (OldTablesEnd == 0) OldTablesEnd = this->GetDataSize();
+   uint32_t OldFileSize = this->GetDataSize();
+
+   if (OldFileSize <= OldTablesEnd) {
+      // Nothing after the old tables. Take over old file buffer and cut off the old tables.
+      // Headers and section data are not copied
+      *this >> ToFile;
+      ToFile.SetSize(NewSymtabOffset);
+   }
+   else {
+      // Copy all headers and all data until TablesOffset
+      ToFile.Push(this->Buf(), NewSymtabOffset);
+   }
    ToFile.Align(WordSize/8);
    NewSymtabOffset = ToFile.GetDataSize(); 
 
@@ -219,20 +236,13 @@ void CMAC2MAC<MACSTRUCTURES>::MakeBinaryFile() {
    ToFile.Align(2);
    NewStringtabEnd = ToFile.GetDataSize();
 
-   // Find end of old tables
-   OldSymtabEnd = this->SymTabOffset + this->SymTabNumber * sizeof(TMAC_nlist);
-   OldStringtabEnd = this->StringTabOffset + this->StringTabSize;
-   OldTablesEnd = OldStringtabEnd;
-   if (OldSymtabEnd > OldTablesEnd) OldTablesEnd = OldSymtabEnd;
-   if (OldTablesEnd == 0) OldTablesEnd = this->GetDataSize();
-
    // Size difference between new and old tables
    SizeDifference = NewStringtabEnd - OldTablesEnd;
 
    // Is there anything in the old file after these tables?
-   if (OldTablesEnd && this->GetDataSize() > OldTablesEnd) {
+   if (OldTablesEnd && OldFileSize > OldTablesEnd) {
       // There is something after these tables. Copy it
-      ToFile.Push(this->Buf() + OldTablesEnd, this->GetDataSize() - OldTablesEnd);
+      ToFile.Push(this->Buf() + OldTablesEnd, OldFileSize - OldTablesEnd);
    }
 }
 
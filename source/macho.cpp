@@ -625,7 +625,7 @@ int MacSymbolTableBuilder<TMAC_nlist, MInt>::TranslateIndex(int OldIndex) {
 }
 
 template <class TMAC_nlist, class MInt>
-void MacSymbolTableBuilder<TMAC_nlist, MInt>::StoreList(CMemoryBuffer * SymbolTable, CMemoryBuffer * StringTable) {
+void MacSymbolTableBuilder<TMAC_nlist, MInt>::StoreList(CMemoryBuffer * SymbolTable, CStringPool * StringTable) {
    // Store sorted list in buffers
 
    // Don't sort list unless commanded to do so. Will mess up indices
@@ -669,14 +669,17 @@ CMACUNIV::CMACUNIV() {
 
 
 void CMACUNIV::Go(int options) {
-   // Apply command options to all components
+   // Apply command options to all components.
+   // If the output is Mach-O and no word size is specified then all components
+   // are converted and put together into a new universal binary
 
    // Check file size
    if (GetDataSize() < 28) return;
 
    // Read number of components
    uint32_t NumComponents = EndianChange(Get<MAC_UNIV_FAT_HEADER>(0).num_arch);
-   if (NumComponents == 0 || NumComponents > 10) {
+   if (NumComponents == 0 
+   || sizeof(MAC_UNIV_FAT_HEADER) + uint64_t(NumComponents) * sizeof(MAC_UNIV_FAT_ARCH) > GetDataSize()) {
       // Number of components too big or too small
       err.submit(2701, NumComponents);
       return;
@@ -684,10 +687,22 @@ void CMACUNIV::Go(int options) {
 
    uint32_t i;                                     // Component number
    uint32_t fo;                                    // File offset of component pointer
+   uint32_t Align;                                 // Alignment of component = 2^Align
    CConverter ComponentBuffer;                   // Used for converting component
    CConverter OutputBuffer;                      // Temporary storage of output file
+   CFileBuffer UniversalBuffer;                  // Output universal binary
    int DesiredWordSize = cmd.DesiredWordSize;    // Desired word size, if specified on command line
 
+   // No output type specified. Modify components
+   if (cmd.OutputType == FILETYPE_MAC_UNIVBIN) cmd.OutputType = FILETYPE_MACHO_LE;
+
+   // Make universal binary if all components can be Mach-O
+   int MakeUniversal = cmd.DumpOptions == 0 && cmd.OutputType == FILETYPE_MACHO_LE && DesiredWordSize == 0;
+   if (MakeUniversal) {
+      // Copy file header and component pointers. Offset and size are updated below
+      UniversalBuffer.Push(Buf(), sizeof(MAC_UNIV_FAT_HEADER) + NumComponents * sizeof(MAC_UNIV_FAT_ARCH));
+   }
+
    // Loop through components
    for (i = 0, fo = sizeof(MAC_UNIV_FAT_HEADER); i < NumComponents; i++, fo += sizeof(MAC_UNIV_FAT_ARCH)) {
 
@@ -699,7 +714,7 @@ void CMACUNIV::Go(int options) {
       uint32_t ComponentSize   = EndianChange(ComponentPointer.size);
 
       // Check within range
-      if (ComponentOffset + ComponentSize > GetDataSize()) {
+      if (uint64_t(ComponentOffset) + ComponentSize > GetDataSize()) {
          err.submit(2016);
          return;
       }
@@ -711,13 +726,16 @@ void CMACUNIV::Go(int options) {
       // Indicate component
       printf("\n\n\nComponent file number %i:\n", i + 1);
 
+      // Each component of a universal binary gets its own word size
+      if (MakeUniversal) cmd.DesiredWordSize = 0;
+
       // Check type
       uint32_t ComponentType = ComponentBuffer.GetFileType();
       if (DesiredWordSize && DesiredWordSize != ComponentBuffer.WordSize) {
          err.submit(1151, ComponentBuffer.WordSize);
       }
       else if (ComponentType != FILETYPE_MACHO_LE) {
-         // Format not supported
+         // Format not supported. Component is copied unchanged into universal binary
          printf("  Format not supported: %s", GetFileFormatName(ComponentType));
       }
       else {
@@ -733,15 +751,31 @@ void CMACUNIV::Go(int options) {
             // Do command
             ComponentBuffer.Go();
             // Is there an output file?
-            if (cmd.DumpOptions == 0) {
+            if (cmd.DumpOptions == 0 && !MakeUniversal) {
                // Save output file
                ComponentBuffer >> OutputBuffer;
             }
          }
       }
+      if (MakeUniversal) {
+         // Put component into universal binary with the same alignment as in input file
+         Align = EndianChange(ComponentPointer.align);
+         if (Align > 15) Align = 12;             // Invalid alignment. Use page size
+         uint32_t NewOffset = (UniversalBuffer.GetDataSize() + (1 << Align) - 1) & (uint32_t)(-(1 << Align));
+         UniversalBuffer.Push(0, NewOffset - UniversalBuffer.GetDataSize());
+         UniversalBuffer.Push(ComponentBuffer.Buf(), ComponentBuffer.GetDataSize());
+         // Update component pointer
+         UniversalBuffer.Get<MAC_UNIV_FAT_ARCH>(fo).offset = EndianChange(NewOffset);
+         UniversalBuffer.Get<MAC_UNIV_FAT_ARCH>(fo).size   = EndianChange(ComponentBuffer.GetDataSize());
+         UniversalBuffer.Get<MAC_UNIV_FAT_ARCH>(fo).align  = EndianChange(Align);
+      }
    }
    // Is there an output file?
-   if (OutputBuffer.GetDataSize()) {
+   if (MakeUniversal) {
+      // Take over universal binary
+      *this << UniversalBuffer;
+   }
+   else if (OutputBuffer.GetDataSize()) {
       // Take over output file and skip remaining components
       *this << OutputBuffer;
    }
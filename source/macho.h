@@ -752,7 +752,7 @@ public:
    void AddSymbol(int OldIndex, const char * name, int type, int Desc, int section, MInt value); // Add symbol to list
    void SortList();                              // Sort the list
    int TranslateIndex(int OldIndex);             // Translate old index to new index, after sorting
-   void StoreList(CMemoryBuffer * SymbolTable, CMemoryBuffer * StringTable); // Store sorted list in buffers
+   void StoreList(CMemoryBuffer * SymbolTable, CStringPool * StringTable); // Store sorted list in buffers
    int Search(const char * name);                // Search for name. -1 if not found
    MacSymbolRecord<TMAC_nlist> & operator[] (uint32_t i);      // Access member
 };
@@ -217,6 +217,7 @@ void CConverter::DumpOMF() {
    COMF omf;                           // Make object for interpreting OMF file
    *this >> omf;                       // Give it my buffer
    omf.ParseFile();                    // Parse file buffer
+   omf.CheckChecksums();               // Verify record checksums
    if (err.Number()) return;           // Return if error
    omf.Dump(cmd.DumpOptions);          // Dump file
    *this << omf;                       // Take back my buffer
@@ -259,6 +260,7 @@ void CConverter::OMF2COF() {
    COMF2COF conv;                      // Make object for conversion 
    *this >> conv;                      // Give it my buffer
    conv.ParseFile();                   // Parse file buffer
+   conv.CheckChecksums();              // Verify record checksums
    if (err.Number()) return;           // Return if error
    conv.Convert();                     // Convert
    *this << conv;                      // Take back converted buffer
@@ -389,6 +391,7 @@ void CConverter::OMF2ASM() {
    COMF2ASM conv;                      // Make object for conversion 
    *this >> conv;                      // Give it my buffer
    conv.ParseFile();                   // Parse file buffer
+   conv.CheckChecksums();              // Verify record checksums
    if (err.Number()) return;           // Return if error
    conv.Convert();                     // Convert
    *this << conv;                      // Take back converted buffer
@@ -498,7 +501,17 @@ void CConverter::Go() {
       if (cmd.Verbose > (uint32_t)(cmd.LibraryOptions != 0)) {
          // Tell what we are doing:
          printf("\nInput file: %s, output file: %s", FileName, OutputFileName);
-         if (FileType != cmd.OutputType) {
+         if (WordSize == 0) {
+            // Universal binary. Word size is indicated for each component
+            if (FileType != cmd.OutputType) {
+               printf("\nConverting components of %s to %s", 
+                  GetFileFormatName(FileType), GetFileFormatName(cmd.OutputType));
+            }
+            else {
+               printf("\nModifying components of %s", GetFileFormatName(FileType));
+            }
+         }
+         else if (FileType != cmd.OutputType) {
             printf("\nConverting from %s%2i to %s%2i", 
                GetFileFormatName(FileType), WordSize, 
                GetFileFormatName(cmd.OutputType), WordSize);
@@ -578,6 +591,12 @@ void CConverter::Go() {
          cmd.ExeptionInfo = (FileType != cmd.OutputType) ? CMDL_EXCEPTION_STRIP : CMDL_EXCEPTION_PRESERVE;
       }
 
+      // Check section garbage collection option
+      if (cmd.SectionGC && !(FileType == FILETYPE_ELF && cmd.OutputType == FILETYPE_COFF)) {
+         err.submit(1064);             // Not supported for this conversion
+         cmd.SectionGC = 0;
+      }
+
       // Choose conversion
       switch (FileType) {
 
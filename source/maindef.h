@@ -98,6 +98,7 @@ static inline uint32_t HighDWord (uint64_t x) {
 #define LIBTYPE_WINDOWS         0x11         // Long member names in "//" member, terminated by 0
 #define LIBTYPE_LINUX           0x12         // Long member names in "//" member, terminated by '/'+LF
 #define LIBTYPE_BSD_MAC         0x13         // Long member name after header. Length indicated by #1/<length>
+#define LIBTYPE_THIN            0x14         // GNU thin archive. Members are paths to object files, stored as Linux long names
 
 // Define constants for symbol scope
 #define S_LOCAL     0                        // Local symbol. Accessed only internally
@@ -94,9 +94,9 @@ COMF::COMF() {
 void COMF::ParseFile() {
    // Parse file buffer
    //uint8_t  RecordType;                            // Type of current record
-   uint32_t Checksum;                              // Record checksum
-   uint32_t ChecksumZero = 0;                      // Count number of records with zero checksum
    SOMFRecordPointer rec;                        // Current record pointer
+   uint32_t DataSegment = 0;                       // Segment of last LEDATA or LIDATA record, 0 after COMDAT
+   CSList<uint32_t> SegmentLastRecord;             // Last record in list of records for each segment
 
    // Make first entry zero in name lists
    LocalNameOffset.PushZero();
@@ -112,21 +112,28 @@ void COMF::ParseFile() {
       // Read record
       //RecordType = rec.Type2;                    // First byte of record = type
 
-      // Compute checksum
-      Checksum = 0;  rec.Index = 0;
-      while (rec.Index < rec.End) Checksum += rec.GetByte();
-      uint32_t CheckByte = rec.GetByte();
-      if ((Checksum + CheckByte) & 0xFF) {
-         // Checksum failed
-         if (CheckByte == 0) {
-            ChecksumZero++;
-         }
-         else err.submit(1202);                  // Checksum error
-      }
-
       // Store record pointer
       rec.Index = 3;                             // Offset to current byte while parsing
       Records.Push(rec);                         // Store record pointer in list
+      NextSegmentRecord.PushZero();              // Link to next record of same segment
+
+      // Link data records and their FIXUPP records into a list for each segment
+      if (rec.Type2 == OMF_LEDATA || rec.Type2 == OMF_LIDATA) {
+         DataSegment = rec.GetIndex();           // Segment index
+         rec.Index = 3;
+      }
+      if (rec.Type2 == OMF_COMDAT) DataSegment = 0; // Fixups refer to COMDAT, not to any segment
+      if (DataSegment && (rec.Type2 == OMF_LEDATA || rec.Type2 == OMF_LIDATA || rec.Type2 == OMF_FIXUPP)) {
+         uint32_t RecNum = Records.GetNumEntries() - 1;
+         if (DataSegment >= SegmentFirstRecord.GetNumEntries()) {
+            // Make room for this segment index
+            SegmentFirstRecord.SetNum(DataSegment + 1);
+            SegmentLastRecord.SetNum(DataSegment + 1);
+         }
+         if (SegmentFirstRecord[DataSegment] == 0) SegmentFirstRecord[DataSegment] = RecNum;
+         else NextSegmentRecord[SegmentLastRecord[DataSegment]] = RecNum;
+         SegmentLastRecord[DataSegment] = RecNum;
+      }
 
       if (rec.Type2 == OMF_LNAMES) {
          // LNAMES record. Store local names by name index
@@ -196,7 +203,31 @@ void COMF::ParseFile() {
    while (rec.GetNext());                        // End of loop through records
 
    NumRecords = Records.GetNumEntries();         // Number of records
+}
+
 
+void COMF::CheckChecksums() {
+   // Verify record checksums.
+   // This is not done by ParseFile. It is called only when converting or dumping the file
+   // A checksum byte of zero that does not match means that the checksum has not been computed
+   uint32_t RecNum;                                // Record number
+   uint32_t ChecksumZero = 0;                      // Count number of records with zero checksum
+   uint8_t  Checksum;                              // Sum of bytes in record, including checksum byte
+   uint8_t * p, * pe;                              // Pointer to record bytes and checksum byte
+
+   for (RecNum = 0; RecNum < NumRecords; RecNum++) {
+      SOMFRecordPointer & rec = Records[RecNum];
+      if ((uint64_t)rec.FileOffset + rec.End >= GetDataSize()) break; // Record extends beyond end of file. Error reported by GetNext
+      p  = (uint8_t*)Buf() + rec.FileOffset;     // First byte of record = record type
+      pe = p + rec.End;                          // Checksum byte
+      Checksum = 0;
+      while (p <= pe) Checksum += *(p++);        // Sum all bytes including checksum byte
+      if (Checksum) {
+         // Checksum failed
+         if (*pe == 0) ChecksumZero++;           // Checksum not computed
+         else err.submit(1202);                  // Checksum error
+      }
+   }
    if (ChecksumZero) printf("\nChecksums are zero"); // This is taken out of the loop to report it only once
 }
 
@@ -459,8 +490,12 @@ void COMF::DumpRelocations() {
          LastDataRecordPointer = Records[i].buffer + Records[i].FileOffset + Records[i].Index;
          printf("\n  LIDATA: segment %s, Offset 0x%X, Size ",
             GetSegmentName(Segment), Offset);
-         // Call recursive function to interpret repeat data block
+         // Call recursive function to interpret each repeat data block
          Size = Records[i].InterpretLIDATABlock();
+         while (Records[i].Index < Records[i].End) {
+            printf(" + ");
+            Size += Records[i].InterpretLIDATABlock();
+         }
          printf(" = 0x%X", Size);
          LastOffset = Offset;
       }
@@ -917,49 +952,69 @@ uint32_t SOMFRecordPointer::InterpretLIDATABlock() {
 }
 
 
+uint32_t SOMFRecordPointer::UnpackLIDATA(int8_t * destination, uint32_t MaxSize) {
+   // Unpack all data blocks in LIDATA record and store data at destination.
+   // Index must point to the first data block, after segment and offset.
+   // Returns total size of expanded data
+   uint32_t Size = 0;                              // Size of data expanded so far
+   while (Index < End) {
+      Size += UnpackLIDATABlock(destination + Size, MaxSize - Size);
+   }
+   return Size;
+}
+
+// Fill Count copies of the Size bytes at destination, doubling the copied area in each step.
+// The first copy must be in place. The total size must be checked by the caller
+static void ReplicateBlock(int8_t * destination, uint32_t Size, uint32_t Count) {
+   uint32_t Total = Size * Count;                  // Total size of all copies
+   uint32_t Done  = Size;                          // Size filled so far
+   uint32_t n;                                     // Size to copy in this step
+   while (Done < Total) {
+      n = Total - Done;  if (n > Done) n = Done;
+      memcpy(destination + Done, destination, n);  // Copy everything filled so far
+      Done += n;
+   }
+}
+
 uint32_t SOMFRecordPointer::UnpackLIDATABlock(int8_t * destination, uint32_t MaxSize) {
-   // Unpack Data block in LIDATA record recursively and store data at destination
+   // Unpack Data block in LIDATA record recursively and store data at destination.
+   // The first repetition is expanded, and the rest are copied from it.
+   // destination = 0 skips the block without storing anything
    uint32_t RepeatCount = GetNumeric();            // Outer repeat count
    uint32_t BlockCount  = GetWord();               // Inner repeat count
-   uint32_t Size = 0;                              // Size of data expanded so far
-   uint32_t RSize;                                 // Size of recursively expanded data
-   uint32_t SaveIndex;                             // Save Index for repetition
-   uint32_t i, j;                                  // Loop counters
+   uint32_t Size = 0;                              // Size of one repetition
+   uint32_t j;                                     // Loop counter
+   if (RepeatCount == 0) destination = 0;          // Nothing to store. Skip contents
    if (BlockCount == 0) {
       // Contains one repeated block
-      Size = GetByte();                          // Size of repeated block
-      if (RepeatCount * Size > MaxSize) {
-         // Data outside allowed area
-         err.submit(2310);                       // Error message
-         Index += Size;                          // Point to after block
-         return 0;                               // No data stored
+      Size = GetByte();                            // Size of repeated block
+      if (destination == 0 || Size == 0) {
+         Index += Size;  return 0;                 // Nothing stored
       }
-
-      // Loop RepeatCount times
-      for (i = 0; i < RepeatCount; i++) {
-         // copy data block into destination
-         memcpy(destination, buffer + FileOffset + Index, Size);
-         destination += Size;
+      if ((uint64_t)RepeatCount * Size > MaxSize) {
+         // Data outside allowed area
+         err.submit(2310);                         // Error message
+         Index += Size;                            // Point to after block
+         return 0;                                 // No data stored
       }
-      Index += Size;                             // Point to after block
-      return RepeatCount * Size;                 // Size of expanded data
+      // Copy data block into destination once, then replicate it
+      memcpy(destination, buffer + FileOffset + Index, Size);
+      ReplicateBlock(destination, Size, RepeatCount);
+      Index += Size;                               // Point to after block
+      return RepeatCount * Size;                   // Size of expanded data
    }
-   // Nested repeat blocks
-   SaveIndex = Index;
-   // Loop RepeatCount times
-   for (i = 0; i < RepeatCount; i++) {
-      // Go back and repeat unpacking
-      Index = SaveIndex;
-      // Loop BlockCount times
-      for (j = 0; j < BlockCount; j++) {
-         // Recursion
-         RSize = UnpackLIDATABlock(destination, MaxSize);
-         destination += RSize;
-         MaxSize -= RSize;
-         Size += RSize;
-      }
+   // Nested repeat blocks. Expand the first repetition recursively
+   for (j = 0; j < BlockCount && Index < End; j++) {
+      Size += UnpackLIDATABlock(destination ? destination + Size : 0, MaxSize - Size);
    }
-   return Size;
+   if (destination == 0 || Size == 0) return 0;
+   if ((uint64_t)RepeatCount * Size > MaxSize) {
+      err.submit(2310);                            // Data outside allowed area
+      return Size;                                 // Only first repetition stored
+   }
+   // Copy the first repetition to the remaining repetitions
+   ReplicateBlock(destination, Size, RepeatCount);
+   return RepeatCount * Size;
 }
 
 
@@ -176,6 +176,7 @@ public:
    void   Start(int8_t * Buffer, uint32_t FileOffset, uint32_t FileEnd); // Start scanning through records
    uint8_t  GetNext(uint32_t align = 0);// Get next record
    uint32_t InterpretLIDATABlock(); // Interpret Data block in LIDATA record recursively
+   uint32_t UnpackLIDATA(int8_t * destination, uint32_t MaxSize); // Unpack all data blocks in LIDATA record and store data at destination
    uint32_t UnpackLIDATABlock(int8_t * destination, uint32_t MaxSize); // Unpack Data block in LIDATA record recursively and store data at destination
 };
 
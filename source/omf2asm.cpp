@@ -571,8 +571,8 @@ void COMF2ASM::MakeSegmentList() {
                err.submit(2310); continue;       // Error: outside bounds
             }
 
-            // Unpack LIDATA blocks recursively
-            RecSize = Records[RecNum].UnpackLIDATABlock(TempBuf.Buf() + RecOffset, SegmentSize - RecOffset);
+            // Unpack all LIDATA blocks
+            RecSize = Records[RecNum].UnpackLIDATA(TempBuf.Buf() + RecOffset, SegmentSize - RecOffset);
 
             if (RecOffset < LastOffset + LastDataRecordSize && LastOffset < RecOffset + RecSize) {
                // Overlapping data records
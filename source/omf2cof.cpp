@@ -44,7 +44,7 @@ void COMF2COF::MakeFileHeader() {
     // Convert subfunction: File header
     // Make PE file header
     NewFileHeader.Machine = PE_MACHINE_I386;
-    NewFileHeader.TimeDateStamp = (uint32_t)time(0);
+    NewFileHeader.TimeDateStamp = cmd.TimeStamp();
     NewFileHeader.SizeOfOptionalHeader = 0;
     NewFileHeader.Flags = 0;
 
@@ -63,6 +63,7 @@ void COMF2COF::MakeSymbolTable1() {
 
     // Initialize new string table. make space for 4-bytes size
     NewStringTable.Push(0, 4);
+    NewStringTable.SetSuffixMerge(cmd.SuffixMerge); // Option -sm: share tails of long names
 
     // Allocate SegmentTranslation buffer
     SegmentTranslation.SetNum(SegmentNameOffset.GetNumEntries());
@@ -477,10 +478,22 @@ void COMF2COF::MakeSections() {
     uint32_t LastOffset;                            // Offset after last LEDATA into segment
     uint32_t FileOffsetData;                        // File offset of first raw data and relocations in new file
     uint32_t FileOffset;                            // File offset of current raw data or relocations
+    CSList<uint32_t> SectionSymbol;                 // Index to auxiliary symbol table entry for each section
 
     // File offset of first data = size of file header and section headers
     FileOffsetData = sizeof(SCOFF_FileHeader) + NewSectionHeaders.GetNumEntries() * sizeof(SCOFF_SectionHeader);
 
+    // Find the symbol table entry for each section. SectionSymbol[SegNum] = index of its auxiliary entry
+    SectionSymbol.SetNum(NewSectionHeaders.GetNumEntries() + 1);
+    for (uint32_t sym = 0; sym < NewSymbolTable.GetNumEntries(); sym++) {
+        SegNum = (uint32_t)NewSymbolTable[sym].s.SectionNumber - 1;
+        if (SegNum < NewSectionHeaders.GetNumEntries() && SectionSymbol[SegNum] == 0
+            && NewSymbolTable[sym].s.StorageClass == COFF_CLASS_STATIC 
+            && NewSymbolTable[sym].s.NumAuxSymbols == 1) {
+                SectionSymbol[SegNum] = sym + 1;
+        }
+    }
+
     // Loop through segments
     for (SegNum = 0; SegNum < NewSectionHeaders.GetNumEntries(); SegNum++) {
 
@@ -503,8 +516,10 @@ void COMF2COF::MakeSections() {
 
         LastOffset = 0;  LastDataRecordSize = 0;
 
-        // Search for LEDATA, LIDATA and FIXUPP records for this segment
-        for (RecNum = 0; RecNum < NumRecords; RecNum++) {
+        // Loop through the LEDATA, LIDATA and FIXUPP records for this segment,
+        // as listed by ParseFile
+        RecNum = DesiredSegment < SegmentFirstRecord.GetNumEntries() ? SegmentFirstRecord[DesiredSegment] : 0;
+        for (; RecNum; RecNum = NextSegmentRecord[RecNum]) {
             if (Records[RecNum].Type2 == OMF_LEDATA) {
 
                 // LEDATA record
@@ -566,8 +581,8 @@ void COMF2COF::MakeSections() {
                     err.submit(2310); return;       // Error: outside bounds
                 }
 
-                // Unpack LIDATA blocks recursively
-                Size = Records[RecNum].UnpackLIDATABlock(TempBuf.Buf() + Offset, SegmentSize - Offset);
+                // Unpack all LIDATA blocks
+                Size = Records[RecNum].UnpackLIDATA(TempBuf.Buf() + Offset, SegmentSize - Offset);
 
                 if (Offset < LastOffset + LastDataRecordSize && LastOffset < Offset + Size) {
                     // Overlapping data records
@@ -789,16 +804,9 @@ void COMF2COF::MakeSections() {
         // Put number of relocations into section header
         NewSectionHeaders[SegNum].NRelocations = (uint16_t)(RelocationTable.GetNumEntries());
 
-        // Put number of relocations into symbol table auxiliary entry.
-        // Search for the symbol table entry for this section:
-        for (uint32_t sym = 0; sym < NewSymbolTable.GetNumEntries(); sym++) {
-            if ((uint32_t)NewSymbolTable[sym].s.SectionNumber == DesiredSegment
-                && NewSymbolTable[sym].s.StorageClass == COFF_CLASS_STATIC 
-                && NewSymbolTable[sym].s.NumAuxSymbols == 1) {
-                    // Found right symbol table entry. Insert NumberOfRelocations
-                    NewSymbolTable[sym+1].section.NumberOfRelocations = NewSectionHeaders[SegNum].NRelocations;
-                    break;  // No need to search further
-            }
+        // Put number of relocations into symbol table auxiliary entry for this section
+        if (SectionSymbol[SegNum]) {
+            NewSymbolTable[SectionSymbol[SegNum]].section.NumberOfRelocations = NewSectionHeaders[SegNum].NRelocations;
         }
     } // End of loop through segments
 }
@@ -33,22 +33,30 @@ uint16_t RotL(uint16_t x, uint16_t bits) {
 
 void COMFHashTable::MakeHash(char * name) {
    // Compute hash according to the official algorithm
+   SOMFHashValues Values;                        // Hash values before modulo NumBlocks
+   ComputeHash(name, Values);
+   SetHash(Values);
+}
+
+
+void COMFHashTable::ComputeHash(char * name, SOMFHashValues & Values) {
+   // Compute the part of the hash that does not depend on the number of blocks.
+   // The values can be saved and reused with SetHash when NumBlocks changes
    char * pb;                                    // Pointer for forward scan through string
    char * pe;                                    // Pointer for backwards scan through string
    uint16_t c;                                   // Current character converted to lower case
    uint16_t BlockX;                              // Calculate block hash
    uint16_t BucketX;                             // Calculate block hash
-   String = name;                                // Type cast string to unsigned char *
-   StringLength = (uint32_t)strlen(name);
+   uint16_t BlockD, BucketD;                     // Calculate step sizes
+   uint32_t StringLength = (uint32_t)strlen(name);
    if (StringLength > 255 || StringLength == 0) {
       // String too long
       err.submit(1204, name);                    // Warning: truncating
       StringLength = 255;
-      String[StringLength] = 0;                  // Truncation modifies string source!
+      name[StringLength] = 0;                    // Truncation modifies string source!
    }
-   String = name;                                // Type cast to unsigned characters
-   pb = String;                                  // Initialize pointer for forward scan
-   pe = String + StringLength;                   // Initialize pointer for backward scan
+   pb = name;                                    // Initialize pointer for forward scan
+   pe = name + StringLength;                     // Initialize pointer for backward scan
    BlockX = BucketD = StringLength | 0x20;       // Initialize left-to-right scan
    BucketX = BlockD = 0;                         // Initialize right-to-left scan
 
@@ -57,20 +65,34 @@ void COMFHashTable::MakeHash(char * name) {
       c = *(--pe) | 0x20;                        // Read character for backward scan, make lower case
       BucketX = RotR(BucketX, 2) ^ c;            // Rotate, XOR
       BlockD  = RotL(BlockD,  2) ^ c;            // Rotate, XOR
-      if (pe == String) break;                   // Stop loop when backward scan finished
+      if (pe == name) break;                     // Stop loop when backward scan finished
       c = *(pb++) | 0x20;                        // Read character for forward scan, make lower case
       BlockX  = RotL(BlockX,  2) ^ c;            // Rotate, XOR
       BucketD = RotR(BucketD, 2) ^ c;            // Rotate, XOR
    }
-   // Make values modulo number of blocks / buckets
-   BlockX = BlockX % NumBlocks;
-   BlockD = BlockD % NumBlocks;
-   if (BlockD == 0) BlockD = 1;
+   // Make bucket values modulo number of buckets
    BucketX = BucketX % OMFNumBuckets;
    BucketD = BucketD % OMFNumBuckets;
    if (BucketD == 0) BucketD = 1;
-   StartBlock  = BlockX;
-   StartBucket = BucketX;
+   Values.String       = name;
+   Values.StringLength = StringLength;
+   Values.BlockX       = BlockX;
+   Values.BlockD       = BlockD;
+   Values.StartBucket  = BucketX;
+   Values.BucketD      = BucketD;
+}
+
+
+void COMFHashTable::SetHash(SOMFHashValues const & Values) {
+   // Set string and search position from hash values made by ComputeHash
+   String       = Values.String;
+   StringLength = Values.StringLength;
+   // Make block values modulo number of blocks
+   StartBlock   = Values.BlockX % NumBlocks;
+   BlockD       = Values.BlockD % NumBlocks;
+   if (BlockD == 0) BlockD = 1;
+   StartBucket  = Values.StartBucket;
+   BucketD      = Values.BucketD;
 }
 
 
@@ -84,6 +106,7 @@ int  COMFHashTable::FindString(uint32_t & ModulePage, uint32_t & Conflicts) {
    uint16_t Bucket;                                // Bucket number
    uint32_t StringIndex;                           // Index to string
    Conflicts = 0;                                // Start counting Conflicts
+   Probes = 0;                                   // Start counting buckets examined
 
    Block = StartBlock;
    Bucket = StartBucket;
@@ -96,6 +119,7 @@ int  COMFHashTable::FindString(uint32_t & ModulePage, uint32_t & Conflicts) {
 
          // String index of current bucket
          StringIndex = blocks[Block].b.Buckets[Bucket];
+         if (Num == 0) Probes++;                 // Count buckets examined until first match
          if (StringIndex == 0) {
             if (blocks[Block].b.FreeSpace < 0xff) {
                // Empty bucket found. End of search
@@ -297,15 +321,30 @@ CMemoryBuffer & StringBuffer, CMemoryBuffer & OutFile, CLibrary * Library) {
 
    CSList<SOMFHashBlock> HashTable;              // Hash table
    COMFHashTable TableHandler;                   // Hash table handler
+   CSList<SOMFHashValues> HashValues;            // Hash values of each symbol, computed only once
+   CSList<SStringEntry> Duplicates;              // Symbols already in table. String = symbol index, Member = module page of first
+   uint32_t NumSymbols;                          // Number of symbols
+   uint32_t SpaceRequired;                       // String space required by all symbols
+   uint32_t MinBlocks;                           // Number of blocks below which the symbols cannot fit
    uint32_t NumBlocksI;                          // Number of blocks as index into prime number table
    uint32_t BlockI;                              // Block index
    uint32_t SymI;                                // Symbol index
-   char * String;                                // Symbol name
    uint16_t Module1, Module2;                    // Module page = offset / page size
    int    Result;                                // 0 = success
 
+   // Compute hash values for all symbols. These do not depend on the number of
+   // blocks, so they can be reused if the table has to be made again with more blocks
+   NumSymbols = StringEntries.GetNumEntries();
+   SpaceRequired = 0;
+   if (NumSymbols) HashValues.SetNum(NumSymbols);
+   for (SymI = 0; SymI < NumSymbols; SymI++) {
+      TableHandler.ComputeHash((char*)StringBuffer.Buf() + StringEntries[SymI].String, HashValues[SymI]);
+      // Space for string + stringlength + module index, rounded up to nearest even
+      SpaceRequired += (HashValues[SymI].StringLength + 4) & uint32_t(-2);
+   }
+
    // Estimate required number of blocks
-   NumBlocks = (StringEntries.GetNumEntries() * 8 + StringBuffer.GetDataSize()) / 256;
+   NumBlocks = (NumSymbols * 8 + StringBuffer.GetDataSize()) / 256;
    // Find nearest prime number >= NumBlocks, but stay within the range from 2 to 251.
    // The minimum NumBlocks is 1, but some systems use 2 as the minimum.
    // The maximum is 251, but some linkers may allow a higher number
@@ -314,6 +353,14 @@ CMemoryBuffer & StringBuffer, CMemoryBuffer & OutFile, CLibrary * Library) {
       if (PrimeNumbers[NumBlocksI] >= NumBlocks) break;
    }
 
+   // Each block has OMFNumBuckets buckets and OMFBlockSize - 2*19 bytes of string space.
+   // Skip the numbers of blocks that are certain to overflow
+   MinBlocks = (NumSymbols + OMFNumBuckets - 1) / OMFNumBuckets;
+   if (MinBlocks < (SpaceRequired + OMFBlockSize - 39) / (OMFBlockSize - 38)) {
+      MinBlocks = (SpaceRequired + OMFBlockSize - 39) / (OMFBlockSize - 38);
+   }
+   while (NumBlocksI < PrimeNumbersLen - 1 && PrimeNumbers[NumBlocksI] < MinBlocks) NumBlocksI++;
+
    // Try if this number of blocks is sufficient
    while (NumBlocksI < PrimeNumbersLen) {
 
@@ -335,30 +382,24 @@ CMemoryBuffer & StringBuffer, CMemoryBuffer & OutFile, CLibrary * Library) {
          TableHandler.blocks[BlockI].b.FreeSpace = 19;
       }
       Result = 0;
+      Duplicates.SetNum(0);
 
       // Insert symbols
       // Loop through symbols
-      for (SymI = 0; SymI < StringEntries.GetNumEntries(); SymI++) {
-
-         // Symbol name
-         String = (char*)StringBuffer.Buf() + StringEntries[SymI].String;
+      for (SymI = 0; SymI < NumSymbols; SymI++) {
 
          // Module page
-         Module1 = Module2 = StringEntries[SymI].Member;
+         Module2 = StringEntries[SymI].Member;
 
          // Insert name in table
-         TableHandler.MakeHash(String);
+         TableHandler.SetHash(HashValues[SymI]);
          Result = TableHandler.InsertString(Module2);
 
          if (Result == 1) {
-            // String already exists
-            // Compose error string "Modulename1 and Modulename2"
-            char ErrorModuleNames[64];
-            strcpy(ErrorModuleNames, Library->GetModuleName(Module1));
-            strcpy(ErrorModuleNames + strlen(ErrorModuleNames), " and ");
-            strcpy(ErrorModuleNames + strlen(ErrorModuleNames), Library->GetModuleName(Module2));
-            // submit error message
-            err.submit(1214, String, ErrorModuleNames);
+            // String already exists. Report it when the table is finished
+            SStringEntry Duplicate;
+            Duplicate.String = SymI;  Duplicate.Member = Module2;
+            Duplicates.Push(Duplicate);
          }
          if (Result == 2) {
             // Table is full. Stop and repeat with a higher NumBlocks
@@ -368,6 +409,19 @@ CMemoryBuffer & StringBuffer, CMemoryBuffer & OutFile, CLibrary * Library) {
 
       if (Result < 2) {
          // Finished with success
+         // Report symbols defined in more than one module
+         for (uint32_t DupI = 0; DupI < Duplicates.GetNumEntries(); DupI++) {
+            SymI = Duplicates[DupI].String;
+            Module1 = StringEntries[SymI].Member;
+            Module2 = Duplicates[DupI].Member;
+            // Compose error string "Modulename1 and Modulename2"
+            char ErrorModuleNames[64];
+            strcpy(ErrorModuleNames, Library->GetModuleName(Module1));
+            strcpy(ErrorModuleNames + strlen(ErrorModuleNames), " and ");
+            strcpy(ErrorModuleNames + strlen(ErrorModuleNames), Library->GetModuleName(Module2));
+            // submit error message
+            err.submit(1214, HashValues[SymI].String, ErrorModuleNames);
+         }
          // Store hash table
          OutFile.Push(&HashTable[0], HashTable.GetNumEntries() * OMFBlockSize);
          return;